@@ -0,0 +1,292 @@
+#include "CommandLine.hpp"
+#include "StudentServer.hpp"
+#include "TableWriter.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+// Records per insertMany() call while importing
+static const size_t IMPORT_BATCH = 1 << 16;
+bool CommandLine::isCommand(const std::string& word) {
+    return word == "import" || word == "export" || word == "query" || word == "list" || word == "stats" || word == "delete"
+        || word == "serve";
+}
+
+bool CommandLine::isClientCommand(const std::string& word) {
+    return word == "client" || word == "loadgen";
+}
+
+void CommandLine::printUsage(std::ostream& out) {
+    out << "Usage: a.exe file1.txt [--journal | --partitioned] [--metrics] [command]\n"
+           "  --partitioned: one file per admission year in file1.txt.parts/, loaded on demand\n"
+           "  --metrics: record operation metrics (JSON on stderr after a command)\n"
+           "Commands:\n"
+           "  import <feed|->          insert records from a tab-separated feed (- = stdin)\n"
+           "  export <file|->          write all records (.sdb = binary snapshot, - = stdout)\n"
+           "  query <field> <value>    field: name, id, admission, birth, dept\n"
+           "  query <field=value> ...  ANDed conditions, 'or' between groups, years as 2001..2003\n"
+           "                           e.g. query dept=civil admission=2024 birth=2003 or name=kim\n"
+           "  query ... --sort <key> [--offset <n>] [--limit <n>]\n"
+           "                           one page of the results in key order (name, id, birth, dept)\n"
+           "  list [key] [offset] [limit]  every record in key order, one page (default: id, all)\n"
+           "  export -, query and list take --format table|tsv|csv (default tsv)\n"
+           "  stats [1] [2] [3]        1) Admission Year 2) Birth Year 3) Department\n"
+           "  delete <id> ...          remove students by ID\n"
+           "  delete <field=value> ... remove every match of a query, e.g. delete admission=2019\n"
+           "  serve <socket>           answer requests on a Unix socket until SHUTDOWN\n"
+           "       a.exe client <socket>   send requests from stdin, print responses\n"
+           "       a.exe loadgen <socket> [requests] [connections] [pipeline] [request...]\n"
+           "                           e.g. loadgen /tmp/sdb.sock 100000 4 32 QUERY admission=2024\n\n";
+}
+
+int CommandLine::run(StudentDB& db, const std::vector<std::string>& words) {
+    std::vector<std::string> args = words;
+    const std::string cmd = args[0];
+    ListOptions opts;
+    if (!takeListOptions(args, opts)) { printUsage(std::cerr); return 1; }
+
+    if (cmd == "import" && args.size() == 2) return importFeed(db, args[1]);
+    if (cmd == "export" && args.size() == 2) return exportAll(db, args[1], opts.format);
+    if (cmd == "query"  && args.size() == 3 && args[1].find('=') == std::string::npos)
+                                             return query(db, args[1], args[2], opts);
+    if (cmd == "query"  && args.size() >= 2) return queryAll(db, std::vector<std::string>(args.begin() + 1, args.end()), opts);
+    if (cmd == "list"   && args.size() <= 4) return list(db, args, opts.format);
+    if (cmd == "stats")                      return stats(db, std::vector<std::string>(args.begin() + 1, args.end()));
+    if (cmd == "delete" && args.size() >= 2) return remove(db, std::vector<std::string>(args.begin() + 1, args.end()));
+    if (cmd == "serve"  && args.size() == 2) return serve(db, args[1]);
+    printUsage(std::cerr);
+    return 1;
+}
+
+int CommandLine::runClient(const std::vector<std::string>& args) {
+    const std::string& cmd = args[0];
+    if (cmd == "client" && args.size() == 2) return StudentClient::run(args[1]);
+    if (cmd == "loadgen" && args.size() >= 2) {
+        size_t num[3] = { 100000, 4, 32 }; // requests, connections, pipeline
+        size_t i = 2;
+        for (size_t k = 0; k < 3 && i < args.size() && !args[i].empty()
+                           && args[i].find_first_not_of("0123456789") == std::string::npos; ++k, ++i) {
+            num[k] = std::stoul(args[i]);
+        }
+        std::string request;
+        for (; i < args.size(); ++i) request += (request.empty() ? "" : " ") + args[i];
+        if (request.empty()) request = "QUERY admission=2024 birth=2003 dept=bio";
+        if (num[1] == 0 || num[2] == 0) { printUsage(std::cerr); return 1; }
+        return StudentClient::load(args[1], request, num[0], num[1], num[2]);
+    }
+    printUsage(std::cerr);
+    return 1;
+}
+
+// ---------- IMPORT ----------
+int CommandLine::importFeed(StudentDB& db, const std::string& source) {
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (source != "-") {
+        file.open(source, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: cannot read file " << source << "\n";
+            return 1;
+        }
+        in = &file;
+    } else {
+        std::ios::sync_with_stdio(false);
+    }
+
+    size_t lineNo = 0, inserted = 0, rejected = 0;
+    std::vector<Student> batch;
+    std::vector<size_t>  batchLines;       // feed line of each batch row, for error reports
+    batch.reserve(IMPORT_BATCH);
+    batchLines.reserve(IMPORT_BATCH);
+    BlockWriter report(stderr);
+
+    auto flushBatch = [&]() {
+        StudentDB::BatchErrors errs;
+        inserted += db.insertMany(batch, errs, false); // saved once below
+        for (const auto& e : errs) {
+            std::string& out = report.buffer();
+            out += "line " + std::to_string(batchLines[e.first]) + ": ";
+            for (size_t i = 0; i < e.second.size(); ++i) {
+                if (i) out += ", ";
+                out += e.second[i];
+            }
+            out += '\n';
+            report.maybeFlush();
+        }
+        rejected += errs.size();
+        batch.clear();
+        batchLines.clear();
+    };
+
+    std::string line;
+    StudentFields f;
+    while (std::getline(*in, line)) {
+        ++lineNo;
+        if (line.empty()) continue;
+        if (!FileStudentRepository::parseLine(line, f)) {
+            report.buffer() += "line " + std::to_string(lineNo) + ": Format\n";
+            report.maybeFlush();
+            ++rejected;
+            continue;
+        }
+        batch.push_back(Student{ std::string(f.name), std::string(f.studentID), f.birthYear,
+                                 std::string(f.department), std::string(f.tel) });
+        batchLines.push_back(lineNo);
+        if (batch.size() == IMPORT_BATCH) flushBatch();
+    }
+    if (!batch.empty()) flushBatch();
+    report.flush();
+
+    bool saved = (inserted == 0) || db.save();
+    std::cerr << "Imported " << inserted << ", rejected " << rejected << "\n";
+    return saved ? 0 : 1;
+}
+
+// ---------- EXPORT ----------
+int CommandLine::exportAll(const StudentDB& db, const std::string& target, TableFormat format) {
+    if (target != "-") return db.exportTo(target) ? 0 : 1;
+
+    TableWriter out(stdout, format);
+    out.header();
+    out.rows(db.sortedBy(SortKey::StudentID));
+    return 0;
+}
+
+// ---------- PAGING ----------
+bool CommandLine::parseSortKey(const std::string& word, SortKey& k) {
+    if      (word == "name")  k = SortKey::Name;
+    else if (word == "id")    k = SortKey::StudentID;
+    else if (word == "birth") k = SortKey::BirthYear;
+    else if (word == "dept")  k = SortKey::Department;
+    else return false;
+    return true;
+}
+
+static bool parseCount(const std::string& word, size_t& n) {
+    if (word.empty() || word.find_first_not_of("0123456789") != std::string::npos) return false;
+    try { n = std::stoull(word); } catch (...) { return false; }
+    return true;
+}
+
+bool CommandLine::takeListOptions(std::vector<std::string>& args, ListOptions& p) {
+    std::vector<std::string> rest;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& a = args[i];
+        if (a != "--sort" && a != "--offset" && a != "--limit" && a != "--format") { rest.push_back(a); continue; }
+        if (i + 1 >= args.size()) return false;
+        const std::string& v = args[++i];
+        if (a == "--format") {
+            if (!TableWriter::parseFormat(v, p.format)) return false;
+            continue;
+        }
+        bool ok = (a == "--sort") ? parseSortKey(v, p.key)
+                : (a == "--offset") ? parseCount(v, p.offset) : parseCount(v, p.limit);
+        if (!ok) return false;
+        p.paged = true;
+    }
+    args.swap(rest);
+    return true;
+}
+
+int CommandLine::list(const StudentDB& db, const std::vector<std::string>& args, TableFormat format) {
+    ListOptions p;
+    if ((args.size() > 1 && !parseSortKey(args[1], p.key))
+        || (args.size() > 2 && !parseCount(args[2], p.offset))
+        || (args.size() > 3 && !parseCount(args[3], p.limit))) {
+        printUsage(std::cerr);
+        return 1;
+    }
+    TableWriter out(stdout, format);
+    out.header();
+    out.rows(db.page(p.key, p.offset, p.limit));
+    return 0;
+}
+
+// ---------- QUERY ----------
+int CommandLine::query(const StudentDB& db, const std::string& field, const std::string& value, const ListOptions& p) {
+    auto year = [&value](int& y) {
+        try { y = std::stoi(value); return true; } catch (...) { return false; }
+    };
+    int y = 0;
+    if (field == "name")                      return printResult(db, db.searchByName(value), p);
+    if (field == "id")                        return printResult(db, db.searchByID(value), p);
+    if (field == "dept")                      return printResult(db, db.searchByDepartmentKeyword(value), p);
+    if (field == "admission" && year(y))      return printResult(db, db.searchByAdmissionYear(y), p);
+    if (field == "birth" && year(y))          return printResult(db, db.searchByBirthYear(y), p);
+    printUsage(std::cerr);
+    return 1;
+}
+
+int CommandLine::queryAll(const StudentDB& db, const std::vector<std::string>& terms, const ListOptions& p) {
+    Query q = Query::all();
+    std::string err;
+    if (!Query::parse(terms, q, err)) {
+        std::cerr << "Error: " << err << "\n";
+        return 1;
+    }
+    return printResult(db, db.find(q), p);
+}
+
+int CommandLine::printResult(const StudentDB& db, const ResultView& res, const ListOptions& p) {
+    TableWriter out(stdout, p.format);
+    out.header();
+    if (p.paged) out.rows(db.page(res, p.key, p.offset, p.limit));
+    else         out.rows(res);
+    return 0;
+}
+
+// ---------- STATS ----------
+int CommandLine::stats(const StudentDB& db, const std::vector<std::string>& keys) {
+    std::vector<StatKey> order;
+    for (const auto& k : keys) {
+        if      (k == "1") order.push_back(StatKey::AdmissionYear);
+        else if (k == "2") order.push_back(StatKey::BirthYear);
+        else if (k == "3") order.push_back(StatKey::Department);
+        else { printUsage(std::cerr); return 1; }
+    }
+    if (order.size() > 3 || std::set<StatKey>(order.begin(), order.end()).size() != order.size()) {
+        printUsage(std::cerr);
+        return 1;
+    }
+    db.groupSummary(order, std::cout);
+    return 0;
+}
+
+// ---------- DELETE ----------
+// Arguments with '=' form a query (every match goes); otherwise they are student IDs
+int CommandLine::remove(StudentDB& db, const std::vector<std::string>& args) {
+    bool byQuery = false;
+    for (const auto& a : args) if (a.find('=') != std::string::npos) byQuery = true;
+
+    size_t removed = 0, missing = 0;
+    if (byQuery) {
+        Query q = Query::all();
+        std::string err;
+        if (!Query::parse(args, q, err)) {
+            std::cerr << "Error: " << err << "\n";
+            return 1;
+        }
+        removed = db.removeWhere(q, false);
+    } else {
+        StudentDB::BatchErrors errs;
+        removed = db.removeMany(args, errs, false);
+        for (const auto& e : errs) std::cerr << args[e.first] << ": " << e.second[0] << "\n";
+        missing = errs.size();
+    }
+
+    bool saved = (removed == 0) || db.save();
+    std::cerr << "Removed " << removed << ", not found " << missing << "\n";
+    return saved ? 0 : 1;
+}
+
+// ---------- SERVER ----------
+int CommandLine::serve(StudentDB& db, const std::string& socketPath) {
+    // Non-owning handle: db outlives the server, and writers only ever copy it
+    ConcurrentStudentDB shared(std::shared_ptr<StudentDB>(std::shared_ptr<StudentDB>(), &db));
+    StudentServer server(shared);
+    if (!server.listen(socketPath)) return 1;
+    std::cerr << "Serving " << socketPath << "\n";
+    server.run();
+    return shared.checkpoint() ? 0 : 1; // leave a complete file behind (no journal)
+}
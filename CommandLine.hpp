@@ -0,0 +1,60 @@
+#ifndef COMMAND_LINE_HPP
+#define COMMAND_LINE_HPP
+
+#include "StudentDB.hpp"
+#include "TableWriter.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Non-interactive subcommands (no menu, no per-record save):
+//   import <feed|->              insert records from a tab-separated feed (stdin with -)
+//   export <file|->              write every record (.sdb gives a snapshot, - writes TSV to stdout)
+//   query  <field> <value>       field: name | id | admission | birth | dept (TSV to stdout)
+//   query  <field=value> ...     compound query (see Query::parse)
+//   list   [key] [offset] [limit]  one page of every record in key order (name | id | birth | dept)
+//   (query accepts --sort <key> --offset <n> --limit <n> to print one page of the results;
+//    export -, query and list accept --format table | tsv | csv)
+//   stats  [1] [2] [3]           group summary (1 Admission Year, 2 Birth Year, 3 Department)
+//   delete <id> ...              remove students by ID
+//   delete <field=value> ...     remove every student matching a compound query (e.g. a cohort)
+//   serve  <socket>              keep the database in memory and answer requests (see StudentServer)
+// Client commands (no student file):
+//   client  <socket>                                   requests from stdin, responses to stdout
+//   loadgen <socket> [requests] [conns] [pipeline] [request...]   measure requests per second
+class CommandLine {
+public:
+    static bool isCommand(const std::string& word);
+    static bool isClientCommand(const std::string& word);
+
+    // Runs args[0] with the remaining words as arguments; returns the process exit code
+    static int run(StudentDB& db, const std::vector<std::string>& args);
+    static int runClient(const std::vector<std::string>& args);
+
+    static void printUsage(std::ostream& out);
+
+private:
+    // Output options: one page of a listing (--sort/--offset/--limit) and --format
+    struct ListOptions {
+        bool        paged{false};
+        SortKey     key{SortKey::StudentID};
+        size_t      offset{0};
+        size_t      limit{SIZE_MAX};
+        TableFormat format{TableFormat::TSV};
+    };
+    // Removes the output options from args; false on a bad key, number or format
+    static bool takeListOptions(std::vector<std::string>& args, ListOptions& p);
+    static bool parseSortKey(const std::string& word, SortKey& k);
+
+    static int importFeed(StudentDB& db, const std::string& source);
+    static int exportAll(const StudentDB& db, const std::string& target, TableFormat format);
+    static int list(const StudentDB& db, const std::vector<std::string>& args, TableFormat format);
+    static int query(const StudentDB& db, const std::string& field, const std::string& value, const ListOptions& p);
+    static int queryAll(const StudentDB& db, const std::vector<std::string>& terms, const ListOptions& p);
+    static int printResult(const StudentDB& db, const ResultView& res, const ListOptions& p);
+    static int stats(const StudentDB& db, const std::vector<std::string>& keys);
+    static int remove(StudentDB& db, const std::vector<std::string>& args);
+    static int serve(StudentDB& db, const std::string& socketPath);
+};
+
+#endif // COMMAND_LINE_HPP
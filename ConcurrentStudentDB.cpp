@@ -0,0 +1,124 @@
+#include "ConcurrentStudentDB.hpp"
+
+ConcurrentStudentDB::ConcurrentStudentDB(std::shared_ptr<StudentDB> db) {
+    // Readers must never load partitions into a published version
+    db->loadAllPartitions();
+    current_ = std::move(db);
+}
+
+ConcurrentStudentDB::Snapshot ConcurrentStudentDB::snapshot() const {
+    return std::atomic_load(&current_);
+}
+
+const StudentDB& ConcurrentStudentDB::Reader::get() {
+    uint64_t v = db_->version();
+    if (v != seen_ || !current_) {
+        current_ = db_->snapshot();
+        seen_ = v;
+    }
+    return *current_;
+}
+
+void ConcurrentStudentDB::publish(std::shared_ptr<StudentDB> next) {
+    std::atomic_store(&current_, std::shared_ptr<const StudentDB>(std::move(next)));
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+// ---------- WRITERS ----------
+bool ConcurrentStudentDB::write(const std::function<bool(StudentDB&)>& fn) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    // Only writers replace current_, and they hold the lock: no atomic_load needed here
+    auto next = std::make_shared<StudentDB>(*current_);
+    if (!fn(*next)) return false;
+    if (!next->save()) return false; // not persisted: readers keep the previous version
+    publish(std::move(next));
+    return true;
+}
+
+bool ConcurrentStudentDB::insert(const Student& s, std::vector<std::string>& err) {
+    if (write([&](StudentDB& db) { return db.insert(s, err); })) return true;
+    if (err.empty()) err.push_back("SAVE");
+    return false;
+}
+
+size_t ConcurrentStudentDB::insertMany(const std::vector<Student>& batch, StudentDB::BatchErrors& errors) {
+    size_t added = 0;
+    if (!write([&](StudentDB& db) {
+        added = db.insertMany(batch, errors, false); // write() saves once
+        return added > 0;
+    })) added = 0;
+    return added;
+}
+
+bool ConcurrentStudentDB::insertFreshman(Student& s, std::vector<std::string>& err, int admissionYear) {
+    if (write([&](StudentDB& db) { return db.insertFreshman(s, err, admissionYear); })) return true;
+    if (err.empty()) err.push_back("SAVE");
+    return false;
+}
+
+size_t ConcurrentStudentDB::insertFreshmen(std::vector<Student>& batch, StudentDB::BatchErrors& errors, int admissionYear) {
+    size_t added = 0;
+    if (!write([&](StudentDB& db) {
+        added = db.insertFreshmen(batch, errors, admissionYear, false);
+        return added > 0;
+    })) added = 0;
+    return added;
+}
+
+bool ConcurrentStudentDB::updateName(const std::string& studentID, const std::string& newName, std::string& err) {
+    if (write([&](StudentDB& db) { return db.updateName(studentID, newName, err); })) return true;
+    if (err.empty()) err = "SAVE";
+    return false;
+}
+
+bool ConcurrentStudentDB::updateDepartment(const std::string& studentID, const std::string& newDept, std::string& err) {
+    if (write([&](StudentDB& db) { return db.updateDepartment(studentID, newDept, err); })) return true;
+    if (err.empty()) err = "SAVE";
+    return false;
+}
+
+bool ConcurrentStudentDB::updateTel(const std::string& studentID, const std::string& newTel, std::string& err) {
+    if (write([&](StudentDB& db) { return db.updateTel(studentID, newTel, err); })) return true;
+    if (err.empty()) err = "SAVE";
+    return false;
+}
+
+bool ConcurrentStudentDB::remove(const std::string& studentID, std::string& err) {
+    if (write([&](StudentDB& db) { return db.remove(studentID, err); })) return true;
+    if (err.empty()) err = "SAVE";
+    return false;
+}
+
+size_t ConcurrentStudentDB::removeMany(const std::vector<std::string>& ids, StudentDB::BatchErrors& errors) {
+    size_t removed = 0;
+    if (!write([&](StudentDB& db) {
+        removed = db.removeMany(ids, errors, false);
+        return removed > 0;
+    })) removed = 0;
+    return removed;
+}
+
+size_t ConcurrentStudentDB::removeWhere(const Query& q) {
+    size_t removed = 0;
+    if (!write([&](StudentDB& db) {
+        removed = db.removeWhere(q, false);
+        return removed > 0;
+    })) removed = 0;
+    return removed;
+}
+
+bool ConcurrentStudentDB::compact() {
+    return write([](StudentDB& db) {
+        if (db.tombstones() == 0) return false;
+        db.compact();
+        return true;
+    });
+}
+
+// Rewrites the file from the latest version in place instead of publishing a copy:
+// checkpoint() only touches the persistence state (pending lines, journal), which
+// readers never access. Every version was created non-const, so the cast is valid.
+bool ConcurrentStudentDB::checkpoint() {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    return std::const_pointer_cast<StudentDB>(current_)->checkpoint();
+}
@@ -0,0 +1,81 @@
+#ifndef CONCURRENT_STUDENT_DB_HPP
+#define CONCURRENT_STUDENT_DB_HPP
+
+#include "StudentDB.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One StudentDB shared by many threads (copy-on-write versions).
+//  - Readers take an immutable snapshot and never wait for writers. Views returned
+//    by a snapshot (ResultView, SortedView) stay valid as long as the snapshot is held.
+//  - Writers are serialized: each write copies the latest version, applies the
+//    change, saves it and publishes the copy as the new version. A write therefore
+//    costs one copy of the database; group related changes into one write().
+class ConcurrentStudentDB {
+public:
+    using Snapshot = std::shared_ptr<const StudentDB>;
+
+    // Takes over an already configured and loaded database (all partitions are loaded)
+    explicit ConcurrentStudentDB(std::shared_ptr<StudentDB> db);
+
+    ConcurrentStudentDB(const ConcurrentStudentDB&) = delete;
+    ConcurrentStudentDB& operator=(const ConcurrentStudentDB&) = delete;
+
+    // Latest published version
+    Snapshot snapshot() const;
+    // Number of versions published so far (changes with every successful write)
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    // Per-thread read handle: get() only touches the shared pointer when a new
+    // version was published since the last call, so steady-state reads are one
+    // atomic load. Not to be shared between threads.
+    class Reader {
+    public:
+        explicit Reader(const ConcurrentStudentDB& db) : db_(&db) {}
+        const StudentDB& get();
+        const Snapshot&  snapshot() { get(); return current_; }
+
+    private:
+        const ConcurrentStudentDB* db_;
+        Snapshot                   current_;
+        uint64_t                   seen_{UINT64_MAX};
+    };
+
+    // Runs fn on a private copy of the latest version. If fn returns true the copy
+    // is saved and published; otherwise, or when the save fails, it is dropped,
+    // readers never see it and false is returned.
+    bool write(const std::function<bool(StudentDB&)>& fn);
+
+    // Writers (same semantics and error reporting as StudentDB; one write each).
+    // When the save fails nothing is applied: the row writers report the error
+    // key "SAVE" and the batch writers return 0.
+    bool   insert(const Student& s, std::vector<std::string>& err);
+    size_t insertMany(const std::vector<Student>& batch, StudentDB::BatchErrors& errors);
+    bool   insertFreshman(Student& s, std::vector<std::string>& err, int admissionYear = StudentDB::FRESHMAN_YEAR);
+    size_t insertFreshmen(std::vector<Student>& batch, StudentDB::BatchErrors& errors,
+                          int admissionYear = StudentDB::FRESHMAN_YEAR);
+    bool   updateName(const std::string& studentID, const std::string& newName, std::string& err);
+    bool   updateDepartment(const std::string& studentID, const std::string& newDept, std::string& err);
+    bool   updateTel(const std::string& studentID, const std::string& newTel, std::string& err);
+    bool   remove(const std::string& studentID, std::string& err);
+    size_t removeMany(const std::vector<std::string>& ids, StudentDB::BatchErrors& errors);
+    size_t removeWhere(const Query& q);
+    // Compacts a copy of the latest version and publishes it; readers keep using
+    // their snapshots meanwhile, so the rebuild never blocks them
+    bool   compact();
+    bool   checkpoint();
+
+private:
+    void publish(std::shared_ptr<StudentDB> next);
+
+    std::shared_ptr<const StudentDB> current_;   // accessed with std::atomic_load/atomic_store only
+    std::atomic<uint64_t>            version_{0};
+    std::mutex                       writeMutex_;
+};
+
+#endif // CONCURRENT_STUDENT_DB_HPP
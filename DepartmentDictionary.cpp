@@ -0,0 +1,76 @@
+#include "DepartmentDictionary.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+DepartmentDictionary& DepartmentDictionary::global() {
+    static DepartmentDictionary instance;
+    return instance;
+}
+
+DepartmentDictionary::DepartmentDictionary() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint16_t id = 0;
+    add(std::string_view(), id); // ID 0: the empty name (also a default-constructed record)
+}
+
+DepartmentDictionary::~DepartmentDictionary() {
+    for (auto& b : blocks_) delete[] b.load();
+}
+
+bool DepartmentDictionary::intern(std::string_view name, uint16_t& id) {
+    // Views in the cache point into entries, which live as long as the process
+    thread_local std::unordered_map<std::string_view, uint16_t> cache;
+    auto hit = cache.find(name);
+    if (hit != cache.end()) { id = hit->second; return true; }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    uint16_t found = 0;
+    if (it != ids_.end()) found = it->second;
+    else if (!add(name, found)) return false;
+    cache.emplace(this->name(found), found);
+    id = found;
+    return true;
+}
+
+bool DepartmentDictionary::add(std::string_view name, uint16_t& out) {
+    size_t id = size_.load(std::memory_order_relaxed);
+    if (id >= CAPACITY) {
+        if (!full_) std::cerr << "Error: more than " << CAPACITY << " department names; rows with new names are rejected\n";
+        full_ = true;
+        return false;
+    }
+    if (id % BLOCK == 0) blocks_[id / BLOCK].store(new Entry[BLOCK], std::memory_order_release);
+
+    Entry& e = entry(static_cast<uint16_t>(id));
+    e.name.assign(name.data(), name.size());
+    e.lower = e.name;
+    for (auto& c : e.lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    // Make room at the new name's rank: shift the larger ones up
+    auto pos = std::lower_bound(byName_.begin(), byName_.end(), name,
+                                [this](uint16_t a, std::string_view n) { return this->name(a) < n; });
+    uint32_t rank = static_cast<uint32_t>(pos - byName_.begin());
+    uint32_t v = version_.load(std::memory_order_relaxed);
+    version_.store(v + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t r = byName_.size(); r-- > rank; ) {
+        entry(byName_[r]).rank.store(static_cast<uint32_t>(r + 1), std::memory_order_relaxed);
+    }
+    e.rank.store(rank, std::memory_order_relaxed);
+    version_.store(v + 2, std::memory_order_release);
+    byName_.insert(pos, static_cast<uint16_t>(id));
+
+    ids_.emplace(e.name, static_cast<uint16_t>(id));
+    size_.store(id + 1, std::memory_order_release);
+    out = static_cast<uint16_t>(id);
+    return true;
+}
+
+void DepartmentDictionary::matching(const std::string& lowerKey, std::vector<uint16_t>& out) const {
+    size_t n = size();
+    for (size_t id = 0; id < n; ++id) {
+        if (lower(static_cast<uint16_t>(id)).find(lowerKey) != std::string::npos) out.push_back(static_cast<uint16_t>(id));
+    }
+}
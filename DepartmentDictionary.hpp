@@ -0,0 +1,89 @@
+#ifndef DEPARTMENT_DICTIONARY_HPP
+#define DEPARTMENT_DICTIONARY_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Process-wide department names: each distinct name gets a small integer ID for the
+// life of the process, so a StudentRecord stores 2 bytes instead of the text.
+// ID 0 is the empty name.
+//
+// Entries never move once published, so name()/lower()/rank() are lock-free reads.
+// intern() is safe from any thread; names the calling thread has seen before are
+// found in a thread-local cache without taking the lock.
+//
+// rank(id) is the position of the name in byte order among all interned names, so
+// sorting and grouping by department compare integers. Interning a new name shifts
+// the larger ranks up by one; the shift is bracketed by a version counter (seqlock),
+// and less() falls back to comparing the names when it overlaps one, so a sort on
+// another thread always sees a consistent order.
+class DepartmentDictionary {
+public:
+    static constexpr size_t CAPACITY = size_t{1} << 16;   // IDs are uint16_t
+
+    static DepartmentDictionary& global();
+
+    // Sets id to the ID of name, added on first use. False, with id unchanged, for a
+    // new name once all CAPACITY IDs are taken (an error is printed the first time):
+    // callers must reject the row rather than store it under another name.
+    bool intern(std::string_view name, uint16_t& id);
+
+    std::string_view   name(uint16_t id)  const { return entry(id).name; }
+    const std::string& lower(uint16_t id) const { return entry(id).lower; }
+    uint32_t           rank(uint16_t id)  const { return entry(id).rank.load(std::memory_order_relaxed); }
+    size_t             size() const { return size_.load(std::memory_order_acquire); }
+    bool               full() const { return size() >= CAPACITY; }
+
+    // Name order of two IDs (byte order, like std::string::compare)
+    bool less(uint16_t a, uint16_t b) const {
+        uint32_t v = version_.load(std::memory_order_acquire);
+        if ((v & 1) == 0) {
+            bool r = rank(a) < rank(b);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version_.load(std::memory_order_relaxed) == v) return r;
+        }
+        return name(a) < name(b);
+    }
+
+    // IDs of the names containing lowerKey (already lower case); each name is checked once
+    void matching(const std::string& lowerKey, std::vector<uint16_t>& out) const;
+
+    DepartmentDictionary(const DepartmentDictionary&) = delete;
+    DepartmentDictionary& operator=(const DepartmentDictionary&) = delete;
+
+private:
+    DepartmentDictionary();
+    ~DepartmentDictionary();
+
+    struct Entry {
+        std::string           name;
+        std::string           lower;
+        std::atomic<uint32_t> rank{0};
+    };
+    static constexpr size_t BLOCK = 256;
+
+    const Entry& entry(uint16_t id) const {
+        return blocks_[id / BLOCK].load(std::memory_order_acquire)[id % BLOCK];
+    }
+    Entry& entry(uint16_t id) {
+        return blocks_[id / BLOCK].load(std::memory_order_acquire)[id % BLOCK];
+    }
+    bool add(std::string_view name, uint16_t& id);   // caller holds mutex_
+
+    std::array<std::atomic<Entry*>, CAPACITY / BLOCK>  blocks_{};
+    std::atomic<size_t>                                size_{0};
+    std::atomic<uint32_t>                              version_{0};   // odd while ranks shift
+    std::mutex                                         mutex_;
+    std::unordered_map<std::string_view, uint16_t>     ids_;      // views into the entries
+    std::vector<uint16_t>                              byName_;   // IDs in name order
+    bool                                               full_{false};
+};
+
+#endif // DEPARTMENT_DICTIONARY_HPP
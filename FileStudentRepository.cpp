@@ -1,12 +1,93 @@
 #include "FileStudentRepository.hpp"
+#include "MappedFile.hpp"
+#include "StudentSnapshot.hpp"
+#include "Metrics.hpp"
+#include <cctype>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
-#include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
 
 FileStudentRepository::FileStudentRepository(std::string path)
 : path_(std::move(path)) {}
 
-bool FileStudentRepository::load(std::vector<Student>& out) const {
+// Same acceptance rules as std::stoi: leading spaces, optional sign, at least one digit,
+// trailing characters ignored, out-of-range values rejected
+static bool parseIntLikeStoi(std::string_view s, int& out) {
+    size_t i = 0;
+    while (i < s.size() && std::isspace(static_cast<unsigned char>(s[i]))) ++i;
+    bool neg = false;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-')) neg = (s[i++] == '-');
+    size_t start = i;
+    long long v = 0;
+    while (i < s.size() && s[i] >= '0' && s[i] <= '9') {
+        v = v * 10 + (s[i] - '0');
+        if (v > static_cast<long long>(std::numeric_limits<int>::max()) + 1) return false;
+        ++i;
+    }
+    if (i == start) return false;
+    if (neg) v = -v;
+    if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max()) return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+// Mirrors std::getline(iss, field, '\t'): fails only when nothing is left to extract
+static bool nextField(std::string_view line, size_t& pos, std::string_view& field) {
+    if (pos >= line.size()) return false;
+    size_t tab = line.find('\t', pos);
+    if (tab == std::string_view::npos) {
+        field = line.substr(pos);
+        pos = line.size();
+    } else {
+        field = line.substr(pos, tab - pos);
+        pos = tab + 1;
+    }
+    return true;
+}
+
+bool FileStudentRepository::parseLine(std::string_view line, StudentFields& f) {
+    size_t pos = 0;
+    std::string_view birthYear;
+    if (!nextField(line, pos, f.name))       return false;
+    if (!nextField(line, pos, f.studentID))  return false;
+    if (!nextField(line, pos, birthYear))    return false;
+    if (!nextField(line, pos, f.department)) return false;
+    if (!nextField(line, pos, f.tel))        f.tel = std::string_view(); //tel is optional
+
+    return parseIntLikeStoi(birthYear, f.birthYear); // Skip records with invalid number format
+}
+
+void FileStudentRepository::parseBuffer(const char* begin, const char* end, const FieldsVisitor& fn) {
+    StudentFields f;
+    const char* p = begin;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* lineEnd = nl ? nl : end;
+        std::string_view line(p, static_cast<size_t>(lineEnd - p));
+        p = nl ? nl + 1 : end;
+
+        if (line.empty()) continue; //skip empty lines
+        if (parseLine(line, f)) fn(f);
+    }
+}
+
+bool FileStudentRepository::scan(const FieldsVisitor& fn) const {
+    Metrics::ScopedTimer timer(MetricOp::RepoScan);
+    if (mode_ == LoadMode::Mapped) {
+        MappedFile map;
+        if (map.open(path_)) {
+            parseBuffer(map.data(), map.data() + map.size(), fn);
+            if (Metrics::enabled()) Metrics::global().addBytesRead(map.size());
+            return true;
+        }
+        // Missing or empty file: the stream path below reports/creates it
+    }
+
     std::ifstream fin(path_);
     if (!fin.is_open()) {
         // Create a new empty file if it doesn't exist, and print a notification message.
@@ -15,33 +96,73 @@ bool FileStudentRepository::load(std::vector<Student>& out) const {
         return create.is_open();
     }
 
-    out.clear();
+    StudentFields f;
     std::string line;
+    uint64_t bytes = 0;
     while (std::getline(fin, line)) {
+        bytes += line.size() + 1;
         if (line.empty()) continue; //skip empty lines
+        if (parseLine(line, f)) fn(f);
+    }
+    if (Metrics::enabled()) Metrics::global().addBytesRead(bytes);
+    return true;
+}
 
-        std::istringstream iss(line);
-        std::string name, studentID, birthYear, dept, tel;
+// Files below this size are parsed on the calling thread
+static const size_t PARALLEL_MIN_BYTES = 1 << 20;
 
-        if (!std::getline(iss, name, '\t'))       continue;
-        if (!std::getline(iss, studentID, '\t'))  continue;
-        if (!std::getline(iss, birthYear, '\t'))  continue;
-        if (!std::getline(iss, dept, '\t'))       continue;
-        if (!std::getline(iss, tel, '\t'))        tel.clear(); //tel is optional
+size_t FileStudentRepository::chunkCount(unsigned workers) {
+    // A few chunks per worker keeps the threads busy when line density varies
+    return workers <= 1 ? 1 : static_cast<size_t>(workers) * 4;
+}
 
-        int by = 0;
-        try { by = std::stoi(birthYear); }
-        catch (...) { continue; } // Skip records with invalid number format
+bool FileStudentRepository::scanParallel(unsigned workers, const ChunkVisitor& fn) const {
+    Metrics::ScopedTimer timer(MetricOp::RepoScanParallel);
+    MappedFile map;
+    if (workers <= 1 || mode_ != LoadMode::Mapped || !map.open(path_) || map.size() < PARALLEL_MIN_BYTES) {
+        map.close();
+        return scan([&fn](const StudentFields& f) { fn(0, f); });
+    }
 
-        //add a new Student record to the vector
-        out.push_back(Student{ name, studentID, by, dept, tel });
+    // Cut points: each chunk starts right after a '\n'
+    const char* base = map.data();
+    const char* end  = base + map.size();
+    const size_t n = chunkCount(workers);
+    std::vector<const char*> cuts(n + 1, end);
+    cuts[0] = base;
+    for (size_t k = 1; k < n; ++k) {
+        const char* p = std::max(cuts[k - 1], base + map.size() / n * k);
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        cuts[k] = nl ? nl + 1 : end;
     }
 
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t k = next++; k < n; k = next++) {
+            parseBuffer(cuts[k], cuts[k + 1], [&fn, k](const StudentFields& f) { fn(k, f); });
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < workers; ++t) pool.emplace_back(work);
+    work(); // the calling thread is one of the workers
+    for (auto& th : pool) th.join();
+    if (Metrics::enabled()) Metrics::global().addBytesRead(map.size());
     return true;
 }
 
+bool FileStudentRepository::load(std::vector<Student>& out) const {
+    out.clear();
+    return scan([&out](const StudentFields& f) {
+        //add a new Student record to the vector
+        out.push_back(Student{ std::string(f.name), std::string(f.studentID), f.birthYear,
+                               std::string(f.department), std::string(f.tel) });
+    });
+}
+
 bool FileStudentRepository::save(const std::vector<Student>& in) const {
-    std::ofstream fout(path_, std::ios::trunc);
+    Metrics::ScopedTimer timer(MetricOp::RepoSave);
+    std::ofstream fout(tempPath(), std::ios::trunc);
     // If the file cannot be opened for writing, print an error and return false
     if (!fout.is_open()) {
         std::cerr << "Error: cannot write file " << path_ << "\n";
@@ -56,5 +177,95 @@ bool FileStudentRepository::save(const std::vector<Student>& in) const {
              << s.department << '\t'
              << s.tel        << '\n';
     }
+    return finishText(fout);
+}
+
+// Closes a text file written to tempPath() and moves it into place
+bool FileStudentRepository::finishText(std::ofstream& fout) const {
+    uint64_t bytes = static_cast<uint64_t>(fout.tellp());
+    fout.close();
+    if (fout.fail()) std::cerr << "Error: cannot write file " << path_ << "\n";
+    if (!replaceWithTemp(!fout.fail())) return false;
+    if (Metrics::enabled()) Metrics::global().addBytesWritten(bytes);
     return true;
 }
+
+bool FileStudentRepository::replaceWithTemp(bool written) const {
+    std::error_code ec;
+    if (written) {
+        std::filesystem::rename(tempPath(), path_, ec);
+        if (!ec) return true;
+        std::cerr << "Error: cannot replace file " << path_ << "\n";
+    }
+    std::filesystem::remove(tempPath(), ec);
+    return false;
+}
+
+// ---------- FORMAT ----------
+FileStudentRepository::FileFormat FileStudentRepository::formatFromExtension(const std::string& path) {
+    static const std::string ext = ".sdb";
+    bool sdb = path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+    return sdb ? FileFormat::Snapshot : FileFormat::Text;
+}
+
+FileStudentRepository::FileFormat FileStudentRepository::format() const {
+    if (StudentSnapshot::isSnapshot(path_)) return FileFormat::Snapshot;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path_, ec);
+    bool blank = ec || size == 0;
+    return blank ? formatFromExtension(path_) : FileFormat::Text;
+}
+
+bool FileStudentRepository::loadSnapshot(std::vector<StudentRecord>& out, bool& validated) const {
+    Metrics::ScopedTimer timer(MetricOp::RepoLoadSnapshot);
+    out.clear();
+    validated = true;
+    std::error_code ec;
+    bool exists = std::filesystem::exists(path_, ec);
+    if (!exists || std::filesystem::file_size(path_, ec) == 0) {
+        // Start an empty snapshot; a missing file is reported like in the text loader
+        bool created = StudentSnapshot::write(path_, out, true);
+        if (!exists) std::cout << "File '" << path_ << "' does not exist. File created.\n\n";
+        return created;
+    }
+    if (Metrics::enabled()) Metrics::global().addBytesRead(std::filesystem::file_size(path_, ec));
+    return StudentSnapshot::read(path_, out, validated);
+}
+
+bool FileStudentRepository::save(const std::vector<StudentRecord>& in, bool validated) const {
+    return saveAs(in, format(), validated);
+}
+
+bool FileStudentRepository::saveAs(const std::vector<StudentRecord>& in, FileFormat f, bool validated) const {
+    Metrics::ScopedTimer timer(MetricOp::RepoSave);
+    if (f == FileFormat::Snapshot) {
+        bool ok = replaceWithTemp(StudentSnapshot::write(tempPath(), in, validated));
+        if (ok && Metrics::enabled()) {
+            std::error_code ec;
+            Metrics::global().addBytesWritten(std::filesystem::file_size(path_, ec));
+        }
+        return ok;
+    }
+
+    std::ofstream fout(tempPath(), std::ios::trunc);
+    if (!fout.is_open()) {
+        std::cerr << "Error: cannot write file " << path_ << "\n";
+        return false;
+    }
+
+    char id[StudentRecord::ID_LEN];
+    char tel[StudentRecord::TEL_MAX];
+    for (const auto& r : in) {
+        r.writeID(id);
+        size_t telLen = r.writeTel(tel);
+        fout.write(r.name().data(), static_cast<std::streamsize>(r.name().size()));
+        fout << '\t';
+        fout.write(id, sizeof(id));
+        fout << '\t' << r.birthYear() << '\t';
+        fout.write(r.department().data(), static_cast<std::streamsize>(r.department().size()));
+        fout << '\t';
+        fout.write(tel, static_cast<std::streamsize>(telLen));
+        fout << '\n';
+    }
+    return finishText(fout);
+}
@@ -2,11 +2,25 @@
 #define FILE_STUDENT_REPOSITORY_HPP
 
 #include "Student.hpp"
+#include "StudentRecord.hpp"
+#include <functional>
+#include <iosfwd>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class FileStudentRepository {
 public:
+    // Mapped: map the file and tokenize in place (default).
+    // Stream: read line by line with std::getline (fallback, also used for empty files).
+    enum class LoadMode { Mapped, Stream };
+
+    // Text: tab-separated lines. Snapshot: binary StudentSnapshot format.
+    enum class FileFormat { Text, Snapshot };
+
+    using FieldsVisitor = std::function<void(const StudentFields&)>;
+    using ChunkVisitor  = std::function<void(size_t chunk, const StudentFields&)>;
+
     explicit FileStudentRepository(std::string path);
 
     // Loads the list of students from the file.
@@ -15,13 +29,53 @@ public:
     // - If birthYear cannot be parsed as an integer, that record is skipped.
     bool load(std::vector<Student>& out) const;
 
+    // Same parsing rules as load(), but hands each record to `fn` as string views
+    // without building any strings (the views are only valid during the call).
+    bool scan(const FieldsVisitor& fn) const;
+
+    // Parallel variant of scan(): the mapped file is cut into chunkCount(workers) pieces
+    // at line boundaries and parsed on `workers` threads. fn runs concurrently for
+    // different chunks (never for the same one); chunk k holds records that come before
+    // those of chunk k+1 in the file. Without a mapping everything is reported as chunk 0.
+    bool scanParallel(unsigned workers, const ChunkVisitor& fn) const;
+    static size_t chunkCount(unsigned workers);
+
     // Saves all student records to the file (tab-separated, each ending with '\n').
+    // Every save writes "<file>.tmp" and renames it over the file, so a failed or
+    // interrupted save leaves the previous contents in place.
     bool save(const std::vector<Student>& in) const;
+    // Saves records in this file's format(); `validated` is recorded in snapshot headers
+    bool save(const std::vector<StudentRecord>& in, bool validated = false) const;
+    bool saveAs(const std::vector<StudentRecord>& in, FileFormat f, bool validated = false) const;
+
+    // Snapshot if the file starts with the snapshot magic; a missing or empty file
+    // is a snapshot if its name ends in ".sdb". Everything else is text.
+    FileFormat        format() const;
+    static FileFormat formatFromExtension(const std::string& path);
+
+    // Reads a snapshot file (creates an empty one, with a notice, if it does not exist)
+    bool loadSnapshot(std::vector<StudentRecord>& out, bool& validated) const;
+
+    void     setLoadMode(LoadMode m) { mode_ = m; }
+    LoadMode loadMode() const { return mode_; }
 
     const std::string& path() const { return path_; }
 
+    // Splits one line (without '\n') into fields; false if the record must be skipped
+    static bool parseLine(std::string_view line, StudentFields& f);
+
+    // Calls fn for every parsable record in [begin, end)
+    static void parseBuffer(const char* begin, const char* end, const FieldsVisitor& fn);
+
 private:
+    std::string tempPath() const { return path_ + ".tmp"; }
+    // Renames tempPath() over the file if it was written completely; otherwise
+    // (or if the rename fails) removes it and leaves the file untouched
+    bool replaceWithTemp(bool written) const;
+    bool finishText(std::ofstream& fout) const;
+
     std::string path_;// Path to the text file storing student records
+    LoadMode    mode_{LoadMode::Mapped};
 };
 
 #endif // FILE_STUDENT_REPOSITORY_HPP
@@ -0,0 +1,62 @@
+#include "Journal.hpp"
+#include "MappedFile.hpp"
+#include "Metrics.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+Journal::Journal(std::string path)
+: path_(std::move(path)) {}
+
+bool Journal::append(std::string_view lines) {
+    if (lines.empty()) return true;
+    Metrics::ScopedTimer timer(MetricOp::JournalAppend);
+    if (!out_.is_open()) {
+        out_.open(path_, std::ios::binary | std::ios::app);
+        if (!out_.is_open()) {
+            std::cerr << "Error: cannot write file " << path_ << "\n";
+            return false;
+        }
+    }
+    out_.write(lines.data(), static_cast<std::streamsize>(lines.size()));
+    out_.flush();
+    if (!out_) return false;
+    size_ += lines.size();
+    if (Metrics::enabled()) Metrics::global().addBytesWritten(lines.size());
+    return true;
+}
+
+bool Journal::replay(const std::function<void(std::string_view line)>& fn) {
+    size_ = 0;
+    MappedFile map;
+    if (!map.open(path_)) return true; // no log (or an empty one): nothing to replay
+
+    const char* p   = map.data();
+    const char* end = p + map.size();
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!nl) break; // torn write
+        if (nl > p) fn(std::string_view(p, static_cast<size_t>(nl - p)));
+        p = nl + 1;
+    }
+    size_ = static_cast<uint64_t>(p - map.data());
+    if (Metrics::enabled()) Metrics::global().addBytesRead(map.size());
+    map.close();
+
+    // Cut off a torn tail so that later appends start on a fresh line
+    std::error_code ec;
+    uintmax_t onDisk = std::filesystem::file_size(path_, ec);
+    if (!ec && onDisk > size_) {
+        std::filesystem::resize_file(path_, size_, ec);
+        if (ec) return false;
+    }
+    return true;
+}
+
+bool Journal::clear() {
+    if (out_.is_open()) out_.close();
+    size_ = 0;
+    std::error_code ec;
+    std::filesystem::remove(path_, ec); // a missing log is fine
+    return !ec;
+}
@@ -0,0 +1,39 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Append-only change log kept next to the student file (one change per line).
+// Changes are appended and flushed; a checkpoint rewrites the base file and clears the log.
+class Journal {
+public:
+    explicit Journal(std::string path);
+
+    // A copy logs to the same file; it opens its own stream on its first append
+    Journal(const Journal& other) : path_(other.path_), size_(other.size_) {}
+    Journal& operator=(const Journal&) = delete;
+
+    // Appends complete lines (each ending with '\n') and flushes them
+    bool append(std::string_view lines);
+
+    // Calls fn for every complete line, in order. A missing log is not an error;
+    // a torn last line (no trailing '\n', e.g. after a crash) is ignored.
+    bool replay(const std::function<void(std::string_view line)>& fn);
+
+    // Removes the log after a checkpoint
+    bool clear();
+
+    uint64_t           size() const { return size_; }   // bytes currently in the log
+    const std::string& path() const { return path_; }
+
+private:
+    std::string   path_;
+    std::ofstream out_;      // opened on the first append
+    uint64_t      size_{0};
+};
+
+#endif // JOURNAL_HPP
@@ -0,0 +1,32 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file (POSIX mmap / Win32 file mapping).
+// Empty or missing files cannot be mapped: open() returns false for them.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const char* data() const { return data_; }
+    size_t      size() const { return size_; }
+
+private:
+    const char* data_{nullptr};
+    size_t      size_{0};
+#ifdef _WIN32
+    void*       file_{nullptr};
+    void*       mapping_{nullptr};
+#endif
+};
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,144 @@
+#include "Metrics.hpp"
+#include <algorithm>
+#include <iomanip>
+
+std::atomic<bool> Metrics::enabled_{false};
+
+Metrics& Metrics::global() {
+    static Metrics instance;
+    return instance;
+}
+
+const char* Metrics::name(MetricOp op) {
+    switch (op) {
+        case MetricOp::Load:                  return "load";
+        case MetricOp::Save:                  return "save";
+        case MetricOp::Checkpoint:            return "checkpoint";
+        case MetricOp::Export:                return "exportTo";
+        case MetricOp::Insert:                return "insert";
+        case MetricOp::InsertMany:            return "insertMany";
+        case MetricOp::InsertFreshman:        return "insertFreshman";
+        case MetricOp::InsertFreshmen:        return "insertFreshmen";
+        case MetricOp::SearchByName:          return "searchByName";
+        case MetricOp::SearchByID:            return "searchByID";
+        case MetricOp::SearchByAdmissionYear: return "searchByAdmissionYear";
+        case MetricOp::SearchByBirthYear:     return "searchByBirthYear";
+        case MetricOp::SearchByDepartment:    return "searchByDepartmentKeyword";
+        case MetricOp::Find:                  return "find";
+        case MetricOp::SortByKey:             return "sortByKey";
+        case MetricOp::SortedBy:              return "sortedBy";
+        case MetricOp::Page:                  return "page";
+        case MetricOp::UpdateName:            return "updateName";
+        case MetricOp::UpdateDepartment:      return "updateDepartment";
+        case MetricOp::UpdateTel:             return "updateTel";
+        case MetricOp::Remove:                return "remove";
+        case MetricOp::RemoveMany:            return "removeMany";
+        case MetricOp::Compact:               return "compact";
+        case MetricOp::GroupSummary:          return "groupSummary";
+        case MetricOp::RepoScan:              return "repository.scan";
+        case MetricOp::RepoScanParallel:      return "repository.scanParallel";
+        case MetricOp::RepoLoadSnapshot:      return "repository.loadSnapshot";
+        case MetricOp::RepoSave:              return "repository.save";
+        case MetricOp::JournalAppend:         return "journal.append";
+        case MetricOp::LoadPartition:         return "loadPartition";
+        default:                              return "?";
+    }
+}
+
+void Metrics::record(MetricOp op, uint64_t nanos) {
+    OpStats& s = ops_[static_cast<size_t>(op)];
+    s.calls.fetch_add(1, std::memory_order_relaxed);
+    s.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+
+    uint64_t prev = s.maxNanos.load(std::memory_order_relaxed);
+    while (nanos > prev && !s.maxNanos.compare_exchange_weak(prev, nanos, std::memory_order_relaxed)) {}
+
+    size_t b = 0; // bit length of nanos
+    for (uint64_t v = nanos; v != 0 && b < BUCKETS - 1; v >>= 1) ++b;
+    s.buckets[b].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::reset() {
+    for (auto& s : ops_) {
+        s.calls = 0;
+        s.totalNanos = 0;
+        s.maxNanos = 0;
+        for (auto& b : s.buckets) b = 0;
+    }
+    bytesRead_ = 0;
+    bytesWritten_ = 0;
+    rejected_ = 0;
+}
+
+uint64_t Metrics::quantile(const OpStats& s, double q) {
+    uint64_t calls = s.calls.load(std::memory_order_relaxed);
+    if (calls == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(calls - 1)) + 1;
+    uint64_t maxNanos = s.maxNanos.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        seen += s.buckets[b].load(std::memory_order_relaxed);
+        if (seen >= rank) return b == 0 ? 0 : std::min((uint64_t{1} << b) - 1, maxNanos);
+    }
+    return maxNanos;
+}
+
+void Metrics::print(std::ostream& out) const {
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::left << std::setw(28) << "Operation" << std::right
+        << std::setw(10) << "Calls"
+        << std::setw(12) << "Total ms"
+        << std::setw(11) << "Mean us"
+        << std::setw(11) << "p50 us"
+        << std::setw(11) << "p99 us"
+        << std::setw(12) << "Max us" << '\n';
+    for (size_t i = 0; i < ops_.size(); ++i) {
+        const OpStats& s = ops_[i];
+        uint64_t calls = s.calls.load(std::memory_order_relaxed);
+        if (calls == 0) continue;
+        double total = static_cast<double>(s.totalNanos.load(std::memory_order_relaxed));
+        out << std::left << std::setw(28) << name(static_cast<MetricOp>(i)) << std::right
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << calls
+            << std::setw(12) << total / 1e6
+            << std::setw(11) << total / 1e3 / static_cast<double>(calls)
+            << std::setw(11) << static_cast<double>(quantile(s, 0.50)) / 1e3
+            << std::setw(11) << static_cast<double>(quantile(s, 0.99)) / 1e3
+            << std::setw(12) << static_cast<double>(s.maxNanos.load(std::memory_order_relaxed)) / 1e3 << '\n';
+    }
+    out << "Bytes read: "    << bytesRead_.load(std::memory_order_relaxed)
+        << ", bytes written: " << bytesWritten_.load(std::memory_order_relaxed)
+        << ", rows rejected by validation on load: " << rejected_.load(std::memory_order_relaxed) << "\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Metrics::dumpJSON(std::ostream& out) const {
+    out << "{\"enabled\":" << (enabled() ? "true" : "false")
+        << ",\"bytesRead\":"    << bytesRead_.load(std::memory_order_relaxed)
+        << ",\"bytesWritten\":" << bytesWritten_.load(std::memory_order_relaxed)
+        << ",\"loadRejected\":" << rejected_.load(std::memory_order_relaxed)
+        << ",\"ops\":{";
+    bool first = true;
+    for (size_t i = 0; i < ops_.size(); ++i) {
+        const OpStats& s = ops_[i];
+        uint64_t calls = s.calls.load(std::memory_order_relaxed);
+        if (calls == 0) continue;
+        out << (first ? "" : ",") << '"' << name(static_cast<MetricOp>(i)) << "\":{"
+            << "\"calls\":"      << calls
+            << ",\"totalNs\":"   << s.totalNanos.load(std::memory_order_relaxed)
+            << ",\"maxNs\":"     << s.maxNanos.load(std::memory_order_relaxed)
+            << ",\"p50Ns\":"     << quantile(s, 0.50)
+            << ",\"p90Ns\":"     << quantile(s, 0.90)
+            << ",\"p99Ns\":"     << quantile(s, 0.99)
+            << ",\"histogram\":[";
+        // Trailing empty buckets are left out; index b = latencies below 2^b ns
+        size_t last = 0;
+        for (size_t b = 0; b < BUCKETS; ++b) if (s.buckets[b].load(std::memory_order_relaxed)) last = b;
+        for (size_t b = 0; b <= last; ++b) out << (b ? "," : "") << s.buckets[b].load(std::memory_order_relaxed);
+        out << "]}";
+        first = false;
+    }
+    out << "}}\n";
+}
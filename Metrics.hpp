@@ -0,0 +1,92 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Operations with a call counter and a latency histogram
+enum class MetricOp {
+    // StudentDB
+    Load, Save, Checkpoint, Export,
+    Insert, InsertMany, InsertFreshman, InsertFreshmen,
+    SearchByName, SearchByID, SearchByAdmissionYear, SearchByBirthYear, SearchByDepartment, Find,
+    SortByKey, SortedBy, Page,
+    UpdateName, UpdateDepartment, UpdateTel,
+    Remove, RemoveMany, Compact,
+    GroupSummary,
+    // FileStudentRepository / Journal / partitions
+    RepoScan, RepoScanParallel, RepoLoadSnapshot, RepoSave, JournalAppend, LoadPartition,
+    Count
+};
+
+// Process-wide operation metrics: call counts, latency histograms (power-of-two
+// nanosecond buckets), bytes read/written and rows rejected while loading.
+// Every counter is a relaxed atomic, so recording is safe from any thread.
+// Disabled by default; when disabled a ScopedTimer costs one relaxed load and
+// no clock reads.
+class Metrics {
+public:
+    static constexpr size_t BUCKETS = 40;   // bucket b holds latencies in [2^(b-1), 2^b) ns
+
+    static Metrics& global();
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+
+    void record(MetricOp op, uint64_t nanos);
+    void addBytesRead(uint64_t n)    { bytesRead_.fetch_add(n, std::memory_order_relaxed); }
+    void addBytesWritten(uint64_t n) { bytesWritten_.fetch_add(n, std::memory_order_relaxed); }
+    void addRejected(uint64_t n)     { rejected_.fetch_add(n, std::memory_order_relaxed); }
+    void reset();
+
+    // Human-readable table (calls, total ms, mean/p50/p99/max in microseconds)
+    void print(std::ostream& out) const;
+    // Machine-readable dump: one JSON object
+    void dumpJSON(std::ostream& out) const;
+
+    static const char* name(MetricOp op);
+
+    // Records the lifetime of the scope as one call of `op` (if enabled at construction)
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(MetricOp op) : op_(op), on_(enabled()) {
+            if (on_) start_ = std::chrono::steady_clock::now();
+        }
+        ~ScopedTimer() {
+            if (!on_) return;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+            global().record(op_, static_cast<uint64_t>(ns.count()));
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        MetricOp                              op_;
+        bool                                  on_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+private:
+    struct OpStats {
+        std::atomic<uint64_t>                         calls{0};
+        std::atomic<uint64_t>                         totalNanos{0};
+        std::atomic<uint64_t>                         maxNanos{0};
+        std::array<std::atomic<uint64_t>, BUCKETS>    buckets{};
+    };
+
+    // Upper bound of the bucket holding quantile q (0..1), in nanoseconds
+    static uint64_t quantile(const OpStats& s, double q);
+
+    static std::atomic<bool> enabled_;
+
+    std::array<OpStats, static_cast<size_t>(MetricOp::Count)> ops_{};
+    std::atomic<uint64_t> bytesRead_{0};
+    std::atomic<uint64_t> bytesWritten_{0};
+    std::atomic<uint64_t> rejected_{0};
+};
+
+#endif // METRICS_HPP
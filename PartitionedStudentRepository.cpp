@@ -0,0 +1,59 @@
+#include "PartitionedStudentRepository.hpp"
+#include "StudentValidator.hpp"
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+PartitionedStudentRepository::PartitionedStudentRepository(const std::string& path)
+: dir_(path + ".parts") {}
+
+std::string PartitionedStudentRepository::partPath(int year) const {
+    return dir_ + "/" + std::to_string(year) + ".txt";
+}
+
+bool PartitionedStudentRepository::exists() const {
+    std::error_code ec;
+    return fs::is_directory(dir_, ec);
+}
+
+bool PartitionedStudentRepository::open() {
+    std::error_code ec;
+    years_.clear();
+    if (!fs::is_directory(dir_, ec) && !fs::create_directories(dir_, ec)) {
+        std::cerr << "Error: cannot create directory " << dir_ << "\n";
+        return false;
+    }
+    // Partition files are "<year>.txt"; anything else in the directory is ignored
+    for (const auto& entry : fs::directory_iterator(dir_, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() != 8 || name.compare(4, 4, ".txt") != 0) continue;
+        int year = 0;
+        bool digits = true;
+        for (size_t i = 0; i < 4; ++i) {
+            if (name[i] < '0' || name[i] > '9') { digits = false; break; }
+            year = year * 10 + (name[i] - '0');
+        }
+        if (digits && StudentValidator::validAdmissionYear(year)) years_.insert(year);
+    }
+    return !ec;
+}
+
+bool PartitionedStudentRepository::load(int year, const FileStudentRepository::FieldsVisitor& fn) const {
+    if (!has(year)) return true;
+    return FileStudentRepository(partPath(year)).scan(fn);
+}
+
+bool PartitionedStudentRepository::save(int year, const std::vector<StudentRecord>& rows) {
+    if (rows.empty()) {
+        std::error_code ec;
+        fs::remove(partPath(year), ec);
+        years_.erase(year);
+        return !ec;
+    }
+    if (!FileStudentRepository(partPath(year)).saveAs(rows, FileStudentRepository::FileFormat::Text, true)) {
+        return false;
+    }
+    years_.insert(year);
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef PARTITIONED_STUDENT_REPOSITORY_HPP
+#define PARTITIONED_STUDENT_REPOSITORY_HPP
+
+#include "FileStudentRepository.hpp"
+#include "StudentRecord.hpp"
+#include <set>
+#include <string>
+#include <vector>
+
+// Students split by admission year (first 4 digits of the student ID):
+//   <path>.parts/<year>.txt   one file per year, in the student file format
+// Each partition is read and written on its own, so StudentDB can load only the
+// years a call needs and rewrite only the years that changed.
+class PartitionedStudentRepository {
+public:
+    explicit PartitionedStudentRepository(const std::string& path);
+
+    // True if the partition directory exists
+    bool exists() const;
+    // Creates the directory if needed and lists the partitions in it
+    bool open();
+
+    const std::set<int>& years() const { return years_; }
+    bool has(int year) const { return years_.count(year) != 0; }
+
+    // Calls fn for every parsable record of one partition (same rules as
+    // FileStudentRepository::scan); a missing partition has no records
+    bool load(int year, const FileStudentRepository::FieldsVisitor& fn) const;
+    // Rewrites one partition; no rows removes its file
+    bool save(int year, const std::vector<StudentRecord>& rows);
+
+    std::string partPath(int year) const;
+    const std::string& dir() const { return dir_; }
+
+private:
+    std::string   dir_;
+    std::set<int> years_;
+};
+
+#endif // PARTITIONED_STUDENT_REPOSITORY_HPP
@@ -0,0 +1,134 @@
+#include "Query.hpp"
+#include "TrigramIndex.hpp"
+#include <cctype>
+
+static std::string lowered(std::string s) {
+    for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+Query Query::all() { return Query(Kind::All); }
+
+Query Query::nameContains(const std::string& keyword) {
+    Query q(Kind::NameContains);
+    q.text_ = lowered(keyword);
+    return q;
+}
+
+Query Query::departmentContains(const std::string& keyword) {
+    Query q(Kind::DeptContains);
+    q.text_ = lowered(keyword);
+    return q;
+}
+
+Query Query::idEquals(const std::string& id10) {
+    Query q(Kind::IDEquals);
+    q.keyValid_ = StudentRecord::packID(id10, q.key_); // malformed IDs match nothing
+    return q;
+}
+
+Query Query::telEquals(const std::string& tel) {
+    Query q(Kind::TelEquals);
+    q.keyValid_ = StudentRecord::packTel(tel, q.key_);
+    return q;
+}
+
+Query Query::admissionYear(int from, int to) {
+    Query q(Kind::AdmissionRange);
+    q.from_ = from; q.to_ = to;
+    return q;
+}
+
+Query Query::birthYear(int from, int to) {
+    Query q(Kind::BirthRange);
+    q.from_ = from; q.to_ = to;
+    return q;
+}
+
+// Flattens nested nodes of the same kind: (a && b) && c has three children
+Query Query::combine(Kind k, Query a, Query b) {
+    Query q(k);
+    for (Query* side : { &a, &b }) {
+        if (side->kind_ == k) {
+            for (auto& c : side->children_) q.children_.push_back(std::move(c));
+        } else {
+            q.children_.push_back(std::move(*side));
+        }
+    }
+    return q;
+}
+
+Query operator&&(Query a, Query b) { return Query::combine(Query::Kind::And, std::move(a), std::move(b)); }
+Query operator||(Query a, Query b) { return Query::combine(Query::Kind::Or,  std::move(a), std::move(b)); }
+
+bool Query::matches(const StudentRecord& r) const {
+    switch (kind_) {
+        case Kind::All:            return true;
+        case Kind::NameContains:   return TrigramIndex::containsFolded(r.name(), text_);
+        case Kind::DeptContains:   return TrigramIndex::containsFolded(r.department(), text_);
+        case Kind::IDEquals:       return keyValid_ && r.id == key_;
+        case Kind::TelEquals:      return keyValid_ && r.telKey() == key_;
+        case Kind::AdmissionRange: return r.admissionYear() >= from_ && r.admissionYear() <= to_;
+        case Kind::BirthRange:     return r.birthYear() >= from_ && r.birthYear() <= to_;
+        case Kind::And:
+            for (const auto& c : children_) if (!c.matches(r)) return false;
+            return true;
+        case Kind::Or:
+            for (const auto& c : children_) if (c.matches(r)) return true;
+            return false;
+        default:
+            return false;
+    }
+}
+
+// "2003" or "2001..2003"
+static bool parseYears(const std::string& v, int& from, int& to) {
+    try {
+        size_t dots = v.find("..");
+        if (dots == std::string::npos) { from = to = std::stoi(v); return true; }
+        from = std::stoi(v.substr(0, dots));
+        to   = std::stoi(v.substr(dots + 2));
+        return from <= to;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool Query::parse(const std::vector<std::string>& words, Query& out, std::string& err) {
+    std::vector<Query> groups;   // OR of ANDs
+    std::vector<Query> terms;
+
+    auto closeGroup = [&]() {
+        if (terms.empty()) return false;
+        Query g = std::move(terms[0]);
+        for (size_t i = 1; i < terms.size(); ++i) g = std::move(g) && std::move(terms[i]);
+        groups.push_back(std::move(g));
+        terms.clear();
+        return true;
+    };
+
+    for (const auto& w : words) {
+        if (w == "or") {
+            if (!closeGroup()) { err = "empty condition before 'or'"; return false; }
+            continue;
+        }
+        size_t eq = w.find('=');
+        if (eq == std::string::npos) { err = "expected field=value: " + w; return false; }
+        std::string field = w.substr(0, eq), value = w.substr(eq + 1);
+        // An empty keyword would match every row (and "delete name=" would empty the table)
+        if (value.empty()) { err = "empty value: " + w; return false; }
+        int from = 0, to = 0;
+        if      (field == "name") terms.push_back(nameContains(value));
+        else if (field == "dept") terms.push_back(departmentContains(value));
+        else if (field == "id")   terms.push_back(idEquals(value));
+        else if (field == "tel")  terms.push_back(telEquals(value));
+        else if (field == "admission" && parseYears(value, from, to)) terms.push_back(admissionYear(from, to));
+        else if (field == "birth"     && parseYears(value, from, to)) terms.push_back(birthYear(from, to));
+        else { err = "invalid condition: " + w; return false; }
+    }
+    if (!closeGroup()) { err = "empty condition"; return false; }
+
+    out = std::move(groups[0]);
+    for (size_t i = 1; i < groups.size(); ++i) out = std::move(out) || std::move(groups[i]);
+    return true;
+}
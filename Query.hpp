@@ -0,0 +1,58 @@
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include "StudentRecord.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Composable predicate over student rows: leaves test one field, And/Or combine them.
+//   auto q = Query::departmentContains("civil") && Query::admissionYear(2024, 2024)
+//                                               && Query::birthYear(2003, 2003);
+// StudentDB::find() plans the evaluation: it reads candidates from the most selective
+// index it can use and checks the rest of the predicate on those rows only.
+class Query {
+public:
+    enum class Kind { All, NameContains, DeptContains, IDEquals, TelEquals,
+                      AdmissionRange, BirthRange, And, Or };
+
+    static Query all();
+    static Query nameContains(const std::string& keyword);        // case-insensitive
+    static Query departmentContains(const std::string& keyword);  // case-insensitive
+    static Query idEquals(const std::string& id10);
+    static Query telEquals(const std::string& tel);
+    static Query admissionYear(int from, int to);                 // inclusive range
+    static Query birthYear(int from, int to);                     // inclusive range
+
+    friend Query operator&&(Query a, Query b);
+    friend Query operator||(Query a, Query b);
+
+    bool matches(const StudentRecord& r) const;
+
+    // Parses "field=value" terms; adjacent terms are ANDed and the word "or" separates
+    // OR groups. Fields: name, dept, id, tel, admission, birth. Years accept "2001..2003".
+    // Empty values ("name=") are rejected.
+    static bool parse(const std::vector<std::string>& words, Query& out, std::string& err);
+
+    Kind                      kind()     const { return kind_; }
+    const std::string&        text()     const { return text_; }   // lower-cased keyword
+    uint64_t                  key()      const { return key_; }    // packed ID / tel key
+    bool                      keyValid() const { return keyValid_; }
+    int                       from()     const { return from_; }
+    int                       to()       const { return to_; }
+    const std::vector<Query>& children() const { return children_; }
+
+private:
+    explicit Query(Kind k) : kind_(k) {}
+    static Query combine(Kind k, Query a, Query b);
+
+    Kind               kind_;
+    std::string        text_;
+    uint64_t           key_{};
+    bool               keyValid_{false};
+    int                from_{};
+    int                to_{};
+    std::vector<Query> children_;
+};
+
+#endif // QUERY_HPP
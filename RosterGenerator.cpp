@@ -0,0 +1,115 @@
+#include "RosterGenerator.hpp"
+#include <cstdio>
+#include <iostream>
+
+// IDs per admission year (6-digit serial)
+static const uint32_t IDS_PER_YEAR = 1000000;
+// Tel numbers are "010" + 8 digits
+static const uint64_t TEL_SPACE = 100000000;
+
+// Serial -> scattered but unique value: multiplying by a number coprime with the
+// modulus is a bijection, so the sequence looks random and never repeats
+static uint64_t scatter(uint64_t serial, uint64_t factor, uint64_t offset, uint64_t modulus) {
+    return (serial * factor + offset) % modulus;
+}
+
+// Writes v as exactly `width` digits (zero-padded)
+static void appendDigits(std::string& out, uint64_t v, size_t width) {
+    size_t at = out.size();
+    out.append(width, '0');
+    for (size_t i = width; i-- > 0; v /= 10) out[at + i] = static_cast<char>('0' + v % 10);
+}
+
+const std::vector<std::string>& RosterGenerator::departments() {
+    static const std::vector<std::string> names = {
+        "Computer Science", "Business", "Mechanical Eng", "Electrical Eng", "Biology",
+        "Economics", "Chemistry", "Civil Eng", "Psychology", "Mathematics",
+        "Physics", "Nursing", "Law", "Architecture", "English", "History",
+        "Music", "Philosophy", "Statistics", "Art", "Korean", "Sociology",
+        "Chemical Eng", "Education", "Media", "Design", "Geography", "Astronomy",
+    };
+    return names;
+}
+
+RosterGenerator::RosterGenerator(uint32_t seed)
+: rng_(seed), usedInYear_(LAST_YEAR - FIRST_YEAR + 1, 0) {
+    // Zipf weights for departments: the k-th largest has 1/k of the first
+    std::vector<double> dw;
+    for (size_t k = 0; k < departments().size(); ++k) dw.push_back(1.0 / static_cast<double>(k + 1));
+    deptDist_ = std::discrete_distribution<int>(dw.begin(), dw.end());
+
+    // Admission years grow towards the present (quadratic ramp)
+    std::vector<double> yw;
+    for (int y = FIRST_YEAR; y <= LAST_YEAR; ++y) {
+        double t = static_cast<double>(y - FIRST_YEAR + 1);
+        yw.push_back(t * t);
+    }
+    yearDist_ = std::discrete_distribution<int>(yw.begin(), yw.end());
+}
+
+std::string RosterGenerator::makeName() {
+    static const char* const syllables[] = {
+        "ka", "min", "jun", "seo", "ho", "yeon", "ji", "woo", "hye", "su",
+        "dan", "bin", "na", "ra", "eun", "tae", "hyun", "so", "mi", "jin",
+    };
+    std::uniform_int_distribution<int> syl(0, 19), count(1, 3);
+    auto word = [&](int n) {
+        std::string w;
+        for (int i = 0; i < n; ++i) w += syllables[syl(rng_)];
+        w[0] = static_cast<char>(w[0] - 'a' + 'A');
+        return w;
+    };
+    std::string name = word(1) + " " + word(count(rng_));
+    if (name.size() > StudentRecord::NAME_MAX) name.resize(StudentRecord::NAME_MAX);
+    if (name.back() == ' ') name.pop_back();
+    return name;
+}
+
+// Skewed year; when that year's serials run out, the next year with room is used
+int RosterGenerator::pickYear() {
+    int idx = yearDist_(rng_);
+    for (size_t tries = 0; tries < usedInYear_.size(); ++tries) {
+        if (usedInYear_[static_cast<size_t>(idx)] < IDS_PER_YEAR) return idx;
+        idx = (idx + 1) % static_cast<int>(usedInYear_.size());
+    }
+    return -1;
+}
+
+StudentRecord RosterGenerator::next() {
+    int idx = pickYear();
+    if (idx < 0 || telCount_ >= TEL_SPACE) return StudentRecord{}; // capacity exhausted
+
+    int year = FIRST_YEAR + idx;
+    uint64_t serial = scatter(usedInYear_[static_cast<size_t>(idx)]++, 7919, 104729u * static_cast<uint64_t>(idx + 1), IDS_PER_YEAR);
+    uint64_t tel    = scatter(telCount_++, 48271, 31337, TEL_SPACE);
+    std::uniform_int_distribution<int> age(18, 21);
+
+    std::string id, telText = "010";
+    appendDigits(id, static_cast<uint64_t>(year), 4);
+    appendDigits(id, serial, 6);
+    appendDigits(telText, tel, 8);
+    StudentRecord r; // the generator's few department names always fit in the dictionary
+    StudentRecord::make(makeName(), id, year - age(rng_),
+                        departments()[static_cast<size_t>(deptDist_(rng_))], telText, r);
+    return r;
+}
+
+bool RosterGenerator::writeFile(const std::string& path, size_t rows) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::cerr << "Error: cannot write file " << path << "\n";
+        return false;
+    }
+    std::string block;
+    block.reserve((1 << 20) + 128);
+    bool ok = true;
+    for (size_t i = 0; i < rows && ok; ++i) {
+        next().appendTSV(block);
+        if (block.size() >= (1 << 20)) {
+            ok = std::fwrite(block.data(), 1, block.size(), f) == block.size();
+            block.clear();
+        }
+    }
+    if (ok && !block.empty()) ok = std::fwrite(block.data(), 1, block.size(), f) == block.size();
+    return (std::fclose(f) == 0) && ok;
+}
@@ -0,0 +1,44 @@
+#ifndef ROSTER_GENERATOR_HPP
+#define ROSTER_GENERATOR_HPP
+
+#include "Student.hpp"
+#include "StudentRecord.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Synthetic roster data for benchmarks. Every row passes StudentValidator, and
+// student IDs and tels are unique over the whole sequence (up to ~26M rows).
+// Distributions are skewed like a real school: a few large departments (Zipf),
+// more students in recent admission years, birth year = admission - 18..21.
+// The same seed always gives the same rows.
+class RosterGenerator {
+public:
+    static constexpr int FIRST_YEAR = 2000;
+    static constexpr int LAST_YEAR  = 2025;
+
+    explicit RosterGenerator(uint32_t seed = 42);
+
+    // Next row
+    StudentRecord next();
+    Student       nextStudent() { return next().toStudent(); }
+
+    // Writes `rows` rows in the student file format; false on I/O error
+    bool writeFile(const std::string& path, size_t rows);
+
+    // Department names, largest first (for keyword queries)
+    static const std::vector<std::string>& departments();
+
+private:
+    std::string makeName();
+    int         pickYear();
+
+    std::mt19937                          rng_;
+    std::discrete_distribution<int>       deptDist_;
+    std::discrete_distribution<int>       yearDist_;
+    std::vector<uint32_t>                 usedInYear_;   // IDs handed out per admission year
+    uint64_t                              telCount_{0};
+};
+
+#endif // ROSTER_GENERATOR_HPP
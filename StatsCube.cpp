@@ -0,0 +1,115 @@
+#include "StatsCube.hpp"
+#include "DepartmentDictionary.hpp"
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace {
+
+// One non-empty cell with its coordinates laid out in the requested grouping order
+struct Cell {
+    std::array<uint32_t, 3> key{};
+    uint32_t                count{};
+};
+
+struct TreePrinter {
+    const std::vector<StatKey>&     order;
+    const std::vector<uint16_t>&    deptByRank;   // rank -> dept id
+    std::ostream&                   out;
+
+    void label(StatKey k, uint32_t v) const {
+        switch (k) {
+            case StatKey::AdmissionYear: out << v << "Admission"; break; // ex) "2025Admission"
+            case StatKey::BirthYear:     out << v << "Born";      break; // ex) "2005Born"
+            case StatKey::Department:    out << DepartmentDictionary::global().name(deptByRank[v]); break;
+        }
+    }
+
+    // cells[begin, end) share the keys above `depth` and are sorted by the rest
+    void print(const std::vector<Cell>& cells, size_t begin, size_t end,
+               size_t depth, const std::string& prefix) const {
+        if (depth >= order.size() || depth >= Cell{}.key.size()) return;
+        size_t i = begin;
+        while (i < end) {
+            uint32_t v = cells[i].key[depth];
+            size_t j = i;
+            uint64_t count = 0;
+            for (; j < end && cells[j].key[depth] == v; ++j) count += cells[j].count;
+            bool isLast = (j == end);
+
+            out << prefix << "+-- ";
+            label(order[depth], v);
+            out << " (" << count << ")\n";
+
+            print(cells, i, j, depth + 1, prefix + (isLast ? "    " : "|   "));
+            i = j;
+        }
+    }
+};
+
+} // namespace
+
+void StatsCube::clear() {
+    cells_.clear();
+    total_ = 0;
+}
+
+uint64_t StatsCube::cellKey(int admissionYear, int birthYear, uint16_t dept) {
+    return (static_cast<uint64_t>(static_cast<uint16_t>(admissionYear)) << 48)
+         | (static_cast<uint64_t>(static_cast<uint16_t>(birthYear)) << 32)
+         | dept;
+}
+
+void StatsCube::add(int admissionYear, int birthYear, uint16_t dept) {
+    ++cells_[cellKey(admissionYear, birthYear, dept)];
+    ++total_;
+}
+
+void StatsCube::remove(int admissionYear, int birthYear, uint16_t dept) {
+    auto it = cells_.find(cellKey(admissionYear, birthYear, dept));
+    if (it == cells_.end()) return;
+    if (--it->second == 0) cells_.erase(it);
+    --total_;
+}
+
+void StatsCube::merge(const StatsCube& other) {
+    for (const auto& [key, count] : other.cells_) cells_[key] += count;
+    total_ += other.total_;
+}
+
+void StatsCube::print(const std::vector<StatKey>& order, std::ostream& out) const {
+    out << "Total (" << total_ << ")\n";
+
+    // Departments are grouped by name, so compare them through their rank in name
+    // order among the departments present in the cube
+    const auto& dict = DepartmentDictionary::global();
+    std::vector<uint16_t> deptByRank;
+    std::vector<uint32_t> rankOf(dict.size());
+    for (const auto& cell : cells_) {
+        uint16_t d = static_cast<uint16_t>(cell.first);
+        if (d >= rankOf.size()) rankOf.resize(d + size_t{1});
+        if (rankOf[d]++ == 0) deptByRank.push_back(d);
+    }
+    std::sort(deptByRank.begin(), deptByRank.end(),
+              [&dict](uint16_t a, uint16_t b) { return dict.less(a, b); });
+    for (uint32_t r = 0; r < deptByRank.size(); ++r) rankOf[deptByRank[r]] = r;
+
+    std::vector<Cell> cells;
+    cells.reserve(cells_.size());
+    for (const auto& [key, count] : cells_) {
+        Cell c;
+        c.count = count;
+        for (size_t d = 0; d < order.size() && d < c.key.size(); ++d) {
+            switch (order[d]) {
+                case StatKey::AdmissionYear: c.key[d] = static_cast<uint32_t>(key >> 48);           break;
+                case StatKey::BirthYear:     c.key[d] = static_cast<uint32_t>((key >> 32) & 0xFFFF); break;
+                case StatKey::Department:    c.key[d] = rankOf[static_cast<uint32_t>(key)];         break;
+            }
+        }
+        cells.push_back(c);
+    }
+    std::sort(cells.begin(), cells.end(), [](const Cell& a, const Cell& b) { return a.key < b.key; });
+
+    TreePrinter{order, deptByRank, out}.print(cells, 0, cells.size(), 0, "");
+}
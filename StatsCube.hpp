@@ -0,0 +1,40 @@
+#ifndef STATS_CUBE_HPP
+#define STATS_CUBE_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+enum class StatKey { AdmissionYear, BirthYear, Department };
+
+// Student counts per (admission year, birth year, department) cell.
+// Departments are DepartmentDictionary IDs, so a cell is one 64-bit key.
+// Kept up to date on insert/update; any grouping order is answered from the
+// cells alone (work proportional to the number of groups, not of students).
+class StatsCube {
+public:
+    void clear();
+
+    void add(int admissionYear, int birthYear, uint16_t dept);
+    void remove(int admissionYear, int birthYear, uint16_t dept);
+
+    // Adds every count of `other`. Used to combine partial cubes built over
+    // disjoint slices of the rows.
+    void merge(const StatsCube& other);
+
+    size_t total() const { return total_; }
+    size_t cellCount() const { return cells_.size(); }
+
+    // Prints the "Total (n)" line and the grouping tree in `order`
+    // ("+-- label (count)" lines, children in ascending key order)
+    void print(const std::vector<StatKey>& order, std::ostream& out) const;
+
+private:
+    static uint64_t cellKey(int admissionYear, int birthYear, uint16_t dept);
+
+    std::unordered_map<uint64_t, uint32_t>  cells_;   // cellKey -> count (no zero cells)
+    size_t                                  total_{0};
+};
+
+#endif // STATS_CUBE_HPP
@@ -2,6 +2,7 @@
 #define STUDENT_HPP
 
 #include <string>
+#include <string_view>
 
 struct Student {
     std::string name;       // Up to 15 chars (letters/spaces), validated externally
@@ -10,11 +11,27 @@ struct Student {
     std::string department; // May contain spaces
     std::string tel;        // Up to 12 digits; empty string is allowed
 
-    // Admission year is the first 4 digits of StudentID
+    // Admission year is the first 4 digits of StudentID (0 if they are not digits)
     int admissionYear() const {
-        if (studentID.size() >= 4) return std::stoi(studentID.substr(0,4));
-        return 0;
+        if (studentID.size() < 4) return 0;
+        int y = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            char c = studentID[i];
+            if (c < '0' || c > '9') return 0;
+            y = y * 10 + (c - '0');
+        }
+        return y;
     }
 };
 
+// Student fields as views (no copies), e.g. one parsed line of the student file.
+// The views are only valid as long as the text they point into.
+struct StudentFields {
+    std::string_view name;
+    std::string_view studentID;
+    int              birthYear{};
+    std::string_view department;
+    std::string_view tel;        // empty if the column is missing
+};
+
 #endif // STUDENT_HPP
@@ -0,0 +1,224 @@
+// Benchmark for every StudentDB operation on synthetic rosters.
+//
+//   studentbench.exe [rows ...] [--ops N] [--threads N]
+//       runs the suite once per roster size (default 10000 100000 1000000)
+//   studentbench.exe --generate <file> <rows> [seed]
+//       only writes a roster file
+//
+// Per operation it prints the number of timed calls, throughput and latency
+// percentiles. Bulk operations (load, save, sort traversal) report rows/s.
+#include "StudentDB.hpp"
+#include "RosterGenerator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// Discards everything (groupSummary output)
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+struct Timing {
+    std::string         op;
+    std::vector<double> micros;   // one entry per call
+    size_t              items{0}; // rows or results touched, for the throughput column
+};
+
+static double percentile(std::vector<double>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = static_cast<size_t>(p * static_cast<double>(v.size() - 1) + 0.5);
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+    return v[k];
+}
+
+static void printHeader() {
+    std::cout << std::left << std::setw(22) << "operation" << std::right
+              << std::setw(9)  << "calls"
+              << std::setw(14) << "ops/s"
+              << std::setw(14) << "items/s"
+              << std::setw(11) << "p50 us"
+              << std::setw(11) << "p90 us"
+              << std::setw(11) << "p99 us"
+              << std::setw(12) << "max us" << '\n';
+}
+
+static void printTiming(Timing& t) {
+    double total = 0;
+    for (double m : t.micros) total += m;
+    double secs = total / 1e6;
+    double maxv = t.micros.empty() ? 0 : *std::max_element(t.micros.begin(), t.micros.end());
+    std::cout << std::left << std::setw(22) << t.op << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9)  << t.micros.size()
+              << std::setw(14) << (secs > 0 ? static_cast<double>(t.micros.size()) / secs : 0)
+              << std::setw(14) << (secs > 0 ? static_cast<double>(t.items) / secs : 0)
+              << std::setw(11) << percentile(t.micros, 0.50)
+              << std::setw(11) << percentile(t.micros, 0.90)
+              << std::setw(11) << percentile(t.micros, 0.99)
+              << std::setw(12) << maxv << '\n';
+}
+
+// Times fn `calls` times; fn returns the number of items it touched
+static Timing measure(const std::string& op, size_t calls, const std::function<size_t(size_t)>& fn) {
+    Timing t;
+    t.op = op;
+    t.micros.reserve(calls);
+    for (size_t i = 0; i < calls; ++i) {
+        auto start = Clock::now();
+        t.items += fn(i);
+        t.micros.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    return t;
+}
+
+static void runSuite(size_t rows, size_t ops, unsigned threads) {
+    const std::string path = "bench_roster_" + std::to_string(rows) + ".txt";
+    std::cout << "\n== " << rows << " rows ==\n";
+
+    RosterGenerator gen(42);
+    auto start = Clock::now();
+    if (!gen.writeFile(path, rows)) return;
+    double genSecs = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "generated in " << std::setprecision(2) << std::fixed << genSecs << " s\n";
+
+    // Rows that are not in the file, for the insert benchmarks (same generator: unique keys)
+    std::vector<Student> fresh;
+    for (size_t i = 0; i < ops; ++i) fresh.push_back(gen.nextStudent());
+
+    std::vector<Timing> results;
+    const size_t bulkCalls = rows >= 1000000 ? 1 : 3;
+
+    results.push_back(measure("load", bulkCalls, [&](size_t) {
+        StudentDB db(path);
+        db.setLoadThreads(threads);
+        db.load();
+        return rows;
+    }));
+
+    StudentDB db(path);
+    db.setLoadThreads(threads);
+    db.load();
+
+    // Query keys taken from the loaded rows
+    std::mt19937 rng(7);
+    std::vector<const StudentRecord*> sample;
+    for (const auto& r : db.sortedBy(SortKey::StudentID)) sample.push_back(&r);
+    std::uniform_int_distribution<size_t> pick(0, sample.empty() ? 0 : sample.size() - 1);
+    const auto& depts = RosterGenerator::departments();
+
+    results.push_back(measure("searchByID", ops, [&](size_t) {
+        return db.searchByID(sample[pick(rng)]->studentID()).size();
+    }));
+    results.push_back(measure("searchByName", ops / 10 + 1, [&](size_t) {
+        std::string key(sample[pick(rng)]->name().substr(0, 4));
+        return db.searchByName(key).size();
+    }));
+    results.push_back(measure("searchByDeptKeyword", ops / 10 + 1, [&](size_t i) {
+        return db.searchByDepartmentKeyword(depts[i % depts.size()].substr(0, 5)).size();
+    }));
+    results.push_back(measure("searchByAdmissionYr", ops / 10 + 1, [&](size_t i) {
+        return db.searchByAdmissionYear(RosterGenerator::FIRST_YEAR + static_cast<int>(i % 26)).size();
+    }));
+    results.push_back(measure("searchByBirthYear", ops / 10 + 1, [&](size_t i) {
+        return db.searchByBirthYear(1980 + static_cast<int>(i % 28)).size();
+    }));
+
+    const SortKey keys[] = { SortKey::Name, SortKey::StudentID, SortKey::BirthYear, SortKey::Department };
+    results.push_back(measure("sortByKey (traverse)", 4, [&](size_t i) {
+        db.setSortKey(keys[i]);
+        size_t n = 0;
+        for (const auto& r : db.sortByKey()) n += r.nameLen != 0;
+        return n;
+    }));
+
+    results.push_back(measure("topK (50)", ops / 10 + 1, [&](size_t i) {
+        return db.topK(keys[i % 4], 50).size();
+    }));
+    results.push_back(measure("page of search (50)", ops / 10 + 1, [&](size_t i) {
+        auto hits = db.searchByAdmissionYear(RosterGenerator::LAST_YEAR - static_cast<int>(i % 3));
+        return db.page(hits, keys[i % 4], 100, 50).size();
+    }));
+
+    NullBuffer nullBuf;
+    std::ostream nullOut(&nullBuf);
+    const std::vector<std::vector<StatKey>> orders = {
+        { StatKey::AdmissionYear }, { StatKey::Department, StatKey::AdmissionYear },
+        { StatKey::Department, StatKey::AdmissionYear, StatKey::BirthYear },
+    };
+    results.push_back(measure("groupSummary", 30, [&](size_t i) {
+        db.groupSummary(orders[i % orders.size()], nullOut);
+        return size_t{1};
+    }));
+
+    results.push_back(measure("insert", fresh.size(), [&](size_t i) {
+        return static_cast<size_t>(db.insert(fresh[i]));
+    }));
+    results.push_back(measure("insertFreshman", std::min<size_t>(ops, 1000), [&](size_t) {
+        Student s = gen.nextStudent(); // valid fields and an unused tel; the ID is replaced
+        std::vector<std::string> err;
+        return static_cast<size_t>(db.insertFreshman(s, err));
+    }));
+
+    // Removes the rows inserted above, then one admission-year cohort; sample is stale after this
+    results.push_back(measure("remove", fresh.size(), [&](size_t i) {
+        std::string err;
+        return static_cast<size_t>(db.remove(fresh[i].studentID, err));
+    }));
+    results.push_back(measure("removeWhere (cohort)", 1, [&](size_t) {
+        return db.removeWhere(Query::admissionYear(RosterGenerator::LAST_YEAR, RosterGenerator::LAST_YEAR), false);
+    }));
+    results.push_back(measure("compact", 1, [&](size_t) {
+        size_t n = db.tombstones();
+        db.compact();
+        return n;
+    }));
+
+    results.push_back(measure("save", bulkCalls, [&](size_t) {
+        db.save();
+        return rows;
+    }));
+
+    printHeader();
+    for (auto& t : results) printTiming(t);
+
+    std::remove(path.c_str());
+    std::remove((path + ".wal").c_str());
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    if (!args.empty() && args[0] == "--generate") {
+        if (args.size() < 3) {
+            std::cerr << "Usage: studentbench.exe --generate <file> <rows> [seed]\n";
+            return 1;
+        }
+        uint32_t seed = args.size() > 3 ? static_cast<uint32_t>(std::stoul(args[3])) : 42;
+        RosterGenerator gen(seed);
+        return gen.writeFile(args[1], std::stoull(args[2])) ? 0 : 1;
+    }
+
+    std::vector<size_t> sizes;
+    size_t ops = 10000;
+    unsigned threads = 0;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if      (args[i] == "--ops" && i + 1 < args.size())     ops = std::stoul(args[++i]);
+        else if (args[i] == "--threads" && i + 1 < args.size()) threads = static_cast<unsigned>(std::stoul(args[++i]));
+        else sizes.push_back(std::stoull(args[i]));
+    }
+    if (sizes.empty()) sizes = { 10000, 100000, 1000000 };
+
+    for (size_t rows : sizes) runSuite(rows, ops, threads);
+    return 0;
+}
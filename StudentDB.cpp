@@ -1,18 +1,45 @@
 #include "StudentDB.hpp"
 #include <algorithm>
-#include <sstream>
 #include <cctype>
 #include <map>
 #include <string>
-#include <random>
-#include <iomanip> 
+#include <numeric>
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <set>
+#include <iterator>
 
 
 StudentDB::StudentDB(const std::string& path)
-: path_(path), repository_(path) {}
+: path_(path), partitions_(path), repository_(path), journal_(path + ".wal") {}
+
+StudentDB::StudentDB(const StudentDB& other)
+: path_(other.path_), data_(other.data_), dead_(other.dead_), deadCount_(other.deadCount_),
+  sortKey_(other.sortKey_), loadThreads_(other.loadThreads_),
+  persistence_(other.persistence_), checkpointBytes_(other.checkpointBytes_),
+  pending_(other.pending_), replaying_(false),
+  partitions_(other.partitions_), loadedYears_(other.loadedYears_), dirtyYears_(other.dirtyYears_),
+  idIndex_(other.idIndex_), telIndex_(other.telIndex_),
+  admissionRows_(other.admissionRows_), birthRows_(other.birthRows_), deptRows_(other.deptRows_),
+  ids_(other.ids_), stats_(other.stats_), useTrigrams_(other.useTrigrams_), nameGrams_(other.nameGrams_),
+  validator_(other.validator_), repository_(other.repository_), journal_(other.journal_) {
+    // sorted_ got comparators bound to this->data_; refill it in the same order (hinted, linear)
+    for (size_t k = 0; k < SORT_KEY_COUNT; ++k) {
+        for (size_t i : other.sorted_[k]) sorted_[k].insert(sorted_[k].end(), i);
+    }
+}
 
 bool StudentDB::isEmpty() const {
-    return data_.empty();
+    if (persistence_ == Persistence::Partitioned) {
+        for (int y : partitions_.years()) if (!loadedYears_.count(y)) return false;
+    }
+    return data_.size() == deadCount_;
+}
+
+size_t StudentDB::size() const {
+    ensureAllYears();
+    return data_.size() - deadCount_;
 }
 
 std::string StudentDB::toLower(std::string s) {
@@ -21,41 +48,448 @@ std::string StudentDB::toLower(std::string s) {
 }
 
 // ---------- DUP CHECK ----------
-bool StudentDB::existsID(const std::string& id) const {
-    for (const Student& s : data_) {
-        if (s.studentID == id) return true;
-    }
-    return false;
+// Text that does not pack (wrong length, non-digits) cannot be stored, hence never exists
+bool StudentDB::existsID(std::string_view id) const {
+    return findByID(id) != npos;
+}
+
+bool StudentDB::existsTel(std::string_view tel) const {
+    uint64_t key = 0;
+    return StudentRecord::packTel(tel, key) && telIndex_.find(key) != telIndex_.end();
+}
+
+size_t StudentDB::findByID(std::string_view id) const {
+    uint64_t key = 0;
+    if (!StudentRecord::packID(id, key)) return npos;
+    auto it = idIndex_.find(key);
+    return (it == idIndex_.end()) ? npos : it->second;
+}
+
+void StudentDB::indexRow(size_t i) {
+    const StudentRecord& r = data_[i];
+    idIndex_.emplace(r.id, i);
+    telIndex_.insert(r.telKey());
+    admissionRows_[r.admissionYear()].push_back(i);
+    birthRows_[r.birthYear()].push_back(i);
+    if (r.dept >= deptRows_.size()) deptRows_.resize(r.dept + size_t{1});
+    deptRows_[r.dept].push_back(i);
+    ids_.markUsed(r.id);
+    stats_.add(r.admissionYear(), r.birthYear(), r.dept);
+    for (auto& idx : sorted_) idx.insert(i);
+    invalidateOrder();
+    if (useTrigrams_) nameGrams_.add(i, r.name());
 }
 
-bool StudentDB::existsTel(const std::string& tel) const {
-    for (const Student& s : data_) {
-        if (s.tel == tel) return true;
+void StudentDB::clearIndexes() {
+    idIndex_.clear();
+    telIndex_.clear();
+    admissionRows_.clear();
+    birthRows_.clear();
+    deptRows_.clear();
+    ids_.clear();
+    stats_.clear();
+    for (auto& idx : sorted_) idx.clear();
+    invalidateOrder();
+    nameGrams_.clear();
+}
+
+// Builds the tel, sorted and trigram indexes and the stats for all of data_ at once.
+// The indexes are independent tasks, run on exactly `workers` threads (the calling
+// thread included) that take the next task from a shared counter, like scanParallel.
+void StudentDB::buildIndexes(unsigned workers) {
+    invalidateOrder();
+    std::vector<std::function<void()>> tasks;
+    // The sorts take longest: queue them first so they start right away
+    for (size_t k = 0; k < SORT_KEY_COUNT; ++k) {
+        tasks.push_back([this, k] {
+            std::vector<size_t> order(data_.size());
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::sort(order.begin(), order.end(), sorted_[k].key_comp());
+            sorted_[k].insert(order.begin(), order.end()); // sorted input: linear insertion
+        });
     }
-    return false;
+    if (useTrigrams_) {
+        tasks.push_back([this] { for (size_t i = 0; i < data_.size(); ++i) nameGrams_.add(i, data_[i].name()); });
+    }
+    tasks.push_back([this] {
+        telIndex_.reserve(data_.size());
+        for (const auto& r : data_) telIndex_.insert(r.telKey());
+    });
+    tasks.push_back([this] {
+        for (size_t i = 0; i < data_.size(); ++i) {
+            admissionRows_[data_[i].admissionYear()].push_back(i);
+            birthRows_[data_[i].birthYear()].push_back(i);
+        }
+    });
+    tasks.push_back([this] {
+        deptRows_.resize(DepartmentDictionary::global().size());
+        for (size_t i = 0; i < data_.size(); ++i) deptRows_[data_[i].dept].push_back(i);
+    });
+
+    // Partitioned aggregation: each slice of data_ is counted into a private cube (no
+    // shared state, no locks), then the partial cubes are merged in slice order.
+    // Merging costs O(cells), which stays small next to the row count.
+    constexpr size_t MIN_SLICE = 1 << 16; // rows; below this a task costs more than it saves
+    size_t slices = std::max<size_t>(1, std::min<size_t>(workers, data_.size() / MIN_SLICE));
+    size_t step = (data_.size() + slices - 1) / slices;
+    std::vector<StatsCube> statParts(slices);
+    for (size_t p = 0; p < slices; ++p) {
+        tasks.push_back([this, &statParts, p, step] {
+            size_t begin = std::min(data_.size(), p * step);
+            size_t end = std::min(data_.size(), begin + step);
+            for (size_t i = begin; i < end; ++i) {
+                statParts[p].add(data_[i].admissionYear(), data_[i].birthYear(), data_[i].dept);
+            }
+        });
+    }
+
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t k = next++; k < tasks.size(); k = next++) tasks[k]();
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < std::min<size_t>(workers, tasks.size()); ++t) pool.emplace_back(work);
+    work(); // the calling thread is one of the workers
+    for (auto& th : pool) th.join();
+    for (const auto& part : statParts) stats_.merge(part);
 }
 
 // ---------- LOAD/SAVE ----------
-bool StudentDB::load() {
-    std::vector<Student> raw;
-    if (!repository_.load(raw)) return false;
+static bool validFields(const StudentFields& f) {
+    return StudentValidator::validRecord(f);
+}
+
+void StudentDB::setLoadThreads(unsigned n) { loadThreads_ = n; }
+unsigned StudentDB::loadThreads() const { return loadThreads_; }
+
+// Same checks as validFields() for a row read from an unvalidated snapshot
+static bool validRecord(const StudentRecord& r) {
+    char id[StudentRecord::ID_LEN];
+    char tel[StudentRecord::TEL_MAX];
+    r.writeID(id);
+    size_t telLen = r.writeTel(tel);
+    return StudentValidator::validName(r.name())
+        && StudentValidator::validStudentID(std::string_view(id, sizeof(id)))
+        && StudentValidator::validBirthYear(r.birthYear())
+        && StudentValidator::validDepartment(r.department())
+        && StudentValidator::validTel(std::string_view(tel, telLen));
+}
 
+// Appends the parts in order, keeping the first occurrence of each ID, then builds the indexes
+void StudentDB::mergeParts(std::vector<std::vector<StudentRecord>>& parts, unsigned workers) {
+    size_t total = 0;
+    for (const auto& part : parts) total += part.size();
+    data_.reserve(total);
+    idIndex_.reserve(total);
+    for (auto& part : parts) {
+        for (const auto& r : part) {
+            if (idIndex_.emplace(r.id, data_.size()).second) data_.push_back(r);
+        }
+        std::vector<StudentRecord>().swap(part);
+    }
+    buildIndexes(workers);
+}
+
+bool StudentDB::load() {
+    Metrics::ScopedTimer timer(MetricOp::Load);
     data_.clear();
-    for (const auto& s : raw) {
-        // Original behavior: load only if validation passes and student ID is unique
-        if (!StudentValidator::validName(s.name))             continue;
-        if (!StudentValidator::validStudentID(s.studentID))   continue;
-        if (!StudentValidator::validBirthYear(s.birthYear))   continue;
-        if (!StudentValidator::validDepartment(s.department)) continue;
-        if (!StudentValidator::validTel(s.tel))               continue;
-        if (existsID(s.studentID))                            continue; // If duplicates exist in file, keep only the first one
-        data_.push_back(s);
+    dead_.clear();
+    deadCount_ = 0;
+    clearIndexes();
+    loadedYears_.clear();
+    dirtyYears_.clear();
+
+    // Partitioned: nothing is read now; each year is loaded by the first call that needs it
+    if (persistence_ == Persistence::Partitioned && partitions_.exists()) return partitions_.open();
+
+    unsigned workers = loadThreads_;
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+
+    if (repository_.format() == FileStudentRepository::FileFormat::Snapshot) {
+        // Binary snapshot: fixed-size rows, validation skipped when the header says so
+        std::vector<std::vector<StudentRecord>> parts(1);
+        bool validated = false;
+        if (!repository_.loadSnapshot(parts[0], validated)) return false;
+        if (!validated) {
+            auto& rows = parts[0];
+            size_t before = rows.size();
+            rows.erase(std::remove_if(rows.begin(), rows.end(),
+                                      [](const StudentRecord& r) { return !validRecord(r); }),
+                       rows.end());
+            if (Metrics::enabled()) Metrics::global().addRejected(before - rows.size());
+        }
+        mergeParts(parts, workers);
+    } else {
+        // Parse + validate + pack on the workers, one output vector per chunk
+        std::vector<std::vector<StudentRecord>> parts(FileStudentRepository::chunkCount(workers));
+        std::vector<size_t> rejected(parts.size(), 0);
+        bool ok = repository_.scanParallel(workers, [&parts, &rejected](size_t chunk, const StudentFields& f) {
+            // Original behavior: load only if validation passes
+            StudentRecord r;
+            if (!validFields(f) || !StudentRecord::make(f.name, f.studentID, f.birthYear, f.department, f.tel, r)) {
+                ++rejected[chunk];
+                return;
+            }
+            parts[chunk].push_back(r);
+        });
+        if (!ok) return false;
+        if (Metrics::enabled()) {
+            Metrics::global().addRejected(std::accumulate(rejected.begin(), rejected.end(), size_t{0}));
+        }
+
+        // Merge in file order so that, if duplicates exist in file, only the first one is kept
+        mergeParts(parts, workers);
+    }
+
+    // Changes saved after the last checkpoint (possibly by a session that crashed)
+    pending_.clear();
+    replaying_ = true;
+    bool replayed = journal_.replay([this](std::string_view line) { replayLine(line); });
+    replaying_ = false;
+    if (!replayed) return false;
+
+    // First partitioned session: split the file into one partition per admission year.
+    // The replayed journal is part of the partitions now; later sessions never read it.
+    if (persistence_ == Persistence::Partitioned) {
+        if (!partitions_.open()) return false;
+        for (const auto& year : admissionRows_) {
+            loadedYears_.insert(year.first);
+            dirtyYears_.insert(year.first);
+        }
+        return savePartitions() && journal_.clear();
     }
     return true;
 }
 
-bool StudentDB::save() const {
-    return repository_.save(data_);
+bool StudentDB::save() {
+    Metrics::ScopedTimer timer(MetricOp::Save);
+    if (persistence_ == Persistence::Rewrite) return checkpoint();
+    if (persistence_ == Persistence::Partitioned) return savePartitions();
+
+    if (!journal_.append(pending_)) return false; // one append for everything since the last save
+    pending_.clear();
+    // The changes are durable once appended; a failed checkpoint is retried on the next save
+    if (journal_.size() >= checkpointBytes_) checkpoint();
+    return true;
+}
+
+bool StudentDB::checkpoint() {
+    Metrics::ScopedTimer timer(MetricOp::Checkpoint);
+    if (persistence_ == Persistence::Partitioned) return savePartitions();
+    std::vector<StudentRecord> scratch;
+    if (!repository_.save(liveRecords(scratch), true)) return false;
+    pending_.clear();
+    return journal_.clear();
+}
+
+bool StudentDB::exportTo(const std::string& path) const {
+    Metrics::ScopedTimer timer(MetricOp::Export);
+    ensureAllYears();
+    FileStudentRepository target(path);
+    std::vector<StudentRecord> scratch;
+    return target.saveAs(liveRecords(scratch), FileStudentRepository::formatFromExtension(path), true);
+}
+
+void StudentDB::setPersistence(Persistence p) { persistence_ = p; }
+Persistence StudentDB::persistence() const { return persistence_; }
+void StudentDB::setCheckpointBytes(uint64_t n) { checkpointBytes_ = n; }
+
+// ---------- PARTITIONS ----------
+// Admission year of a student ID (0 if the text is not a valid ID)
+static int idYear(std::string_view id) {
+    uint64_t key = 0;
+    return StudentRecord::packID(id, key) ? static_cast<int>(key / 1000000) : 0;
+}
+
+// Admission years q can match; false if any year can match (no ID or admission bound)
+static bool queryYears(const Query& q, std::set<int>& years) {
+    switch (q.kind()) {
+        case Query::Kind::IDEquals:
+            if (q.keyValid()) years.insert(static_cast<int>(q.key() / 1000000));
+            return true;
+        case Query::Kind::AdmissionRange:
+            for (int y = std::max(q.from(), 1900); y <= std::min(q.to(), 2100); ++y) years.insert(y);
+            return true;
+        case Query::Kind::And: {
+            bool bounded = false;
+            std::set<int> common;
+            for (const auto& c : q.children()) {
+                std::set<int> ys;
+                if (!queryYears(c, ys)) continue;
+                if (!bounded) common.swap(ys);
+                else {
+                    std::set<int> both;
+                    std::set_intersection(common.begin(), common.end(), ys.begin(), ys.end(),
+                                          std::inserter(both, both.end()));
+                    common.swap(both);
+                }
+                bounded = true;
+            }
+            if (bounded) years.insert(common.begin(), common.end());
+            return bounded;
+        }
+        case Query::Kind::Or:
+            for (const auto& c : q.children()) if (!queryYears(c, years)) return false;
+            return true;
+        default:
+            return false;
+    }
+}
+
+void StudentDB::loadAllPartitions() {
+    ensureAllYears();
+}
+
+// Years without a partition file (e.g. 0 from a malformed ID) have nothing to load:
+// no file access, and they are not recorded as loaded
+void StudentDB::ensureYear(int year) const {
+    if (persistence_ != Persistence::Partitioned || loadedYears_.count(year) || !partitions_.has(year)) return;
+    const_cast<StudentDB*>(this)->loadPartitions({ year });
+}
+
+void StudentDB::ensureAllYears() const {
+    if (persistence_ != Persistence::Partitioned) return;
+    std::vector<int> missing;
+    for (int y : partitions_.years()) if (!loadedYears_.count(y)) missing.push_back(y);
+    if (!missing.empty()) const_cast<StudentDB*>(this)->loadPartitions(missing);
+}
+
+void StudentDB::ensureQueryYears(const Query& q) const {
+    if (persistence_ != Persistence::Partitioned) return;
+    std::set<int> years;
+    if (!queryYears(q, years)) { ensureAllYears(); return; }
+    for (int y : years) ensureYear(y);
+}
+
+// Reads the given partitions (in parallel when there are several) and adds their
+// rows: bulk index build if nothing is loaded yet, row by row otherwise
+void StudentDB::loadPartitions(const std::vector<int>& years) {
+    Metrics::ScopedTimer timer(MetricOp::LoadPartition);
+    std::vector<std::vector<StudentRecord>> parts(years.size());
+    std::vector<size_t> rejected(years.size(), 0);
+
+    unsigned workers = loadThreads_;
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::min<size_t>(workers, years.size()));
+
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t k = next++; k < years.size(); k = next++) {
+            partitions_.load(years[k], [&parts, &rejected, k](const StudentFields& f) {
+                StudentRecord r;
+                if (!validFields(f) || !StudentRecord::make(f.name, f.studentID, f.birthYear, f.department, f.tel, r)) {
+                    ++rejected[k];
+                    return;
+                }
+                parts[k].push_back(r);
+            });
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < workers; ++t) pool.emplace_back(work);
+    work();
+    for (auto& th : pool) th.join();
+    if (Metrics::enabled()) {
+        Metrics::global().addRejected(std::accumulate(rejected.begin(), rejected.end(), size_t{0}));
+    }
+
+    loadedYears_.insert(years.begin(), years.end());
+    if (data_.empty()) {
+        mergeParts(parts, workers);
+        return;
+    }
+    for (const auto& part : parts) {
+        for (const auto& r : part) {
+            if (idIndex_.count(r.id)) continue;
+            data_.push_back(r);
+            indexRow(data_.size() - 1);
+        }
+    }
+}
+
+// Rewrites the partitions changed since the last save (rows of a year in insertion order)
+bool StudentDB::savePartitions() {
+    bool ok = true;
+    std::vector<StudentRecord> rows;
+    for (auto it = dirtyYears_.begin(); it != dirtyYears_.end(); ) {
+        rows.clear();
+        auto bucket = admissionRows_.find(*it);
+        if (bucket != admissionRows_.end()) {
+            rows.reserve(bucket->second.size());
+            for (size_t i : bucket->second) if (alive(i)) rows.push_back(data_[i]);
+        }
+        if (partitions_.save(*it, rows)) it = dirtyYears_.erase(it);
+        else { ok = false; ++it; }
+    }
+    pending_.clear();
+    return ok;
+}
+
+// ---------- JOURNAL ----------
+// Line format (tab-separated, like the student file):
+//   INS  name id birthYear department tel
+//   NAME id newName
+//   DEPT id newDepartment
+//   TEL  id newTel
+//   DEL  id
+// Replaying is idempotent: a line already reflected in the file is rejected as a duplicate
+// or rewrites the same value, so a crash between checkpoint steps loses nothing.
+void StudentDB::logInsert(const StudentRecord& r) {
+    if (replaying_) return;
+    if (persistence_ == Persistence::Partitioned) { dirtyYears_.insert(r.admissionYear()); return; }
+    pending_ += "INS\t";
+    r.appendTSV(pending_);
+}
+
+void StudentDB::logRemove(const StudentRecord& r) {
+    if (replaying_) return;
+    if (persistence_ == Persistence::Partitioned) { dirtyYears_.insert(r.admissionYear()); return; }
+    char id[StudentRecord::ID_LEN];
+    r.writeID(id);
+    pending_ += "DEL\t";
+    pending_.append(id, sizeof(id));
+    pending_ += '\n';
+}
+
+void StudentDB::logUpdate(const char* tag, std::string_view id, std::string_view value) {
+    if (replaying_) return;
+    if (persistence_ == Persistence::Partitioned) { dirtyYears_.insert(idYear(id)); return; }
+    pending_ += tag;
+    pending_ += '\t';
+    pending_.append(id.data(), id.size());
+    pending_ += '\t';
+    pending_.append(value.data(), value.size());
+    pending_ += '\n';
+}
+
+void StudentDB::replayLine(std::string_view line) {
+    size_t tab = line.find('\t');
+    if (tab == std::string_view::npos) return;
+    std::string_view tag  = line.substr(0, tab);
+    std::string_view rest = line.substr(tab + 1);
+
+    if (tag == "INS") {
+        StudentFields f;
+        if (!FileStudentRepository::parseLine(rest, f)) return;
+        std::vector<std::string> err;
+        insert(Student{ std::string(f.name), std::string(f.studentID), f.birthYear,
+                        std::string(f.department), std::string(f.tel) }, err);
+        return;
+    }
+    if (tag == "DEL") {
+        std::string err;
+        remove(std::string(rest), err);
+        return;
+    }
+
+    size_t sep = rest.find('\t');
+    if (sep == std::string_view::npos) return;
+    std::string id(rest.substr(0, sep));
+    std::string value(rest.substr(sep + 1));
+    std::string err;
+    if      (tag == "NAME") updateName(id, value, err);
+    else if (tag == "DEPT") updateDepartment(id, value, err);
+    else if (tag == "TEL")  updateTel(id, value, err);
 }
 
 // ---------- INSERTION ----------
@@ -64,244 +498,586 @@ bool StudentDB::insert(const Student& s) {
     return insert(s, err);
 }
 
-bool StudentDB::insert(const Student& s, std::vector<std::string>& err) {
-    // Pre-check for duplicate student ID/telephone (keep original behavior/message)
-    if (existsID(s.studentID)) { err.push_back("DUP_ID"); return false; }
-    if (existsTel(s.tel))      { err.push_back("DUP_TEL"); return false; }
-
-    // Field validation (preserve original key strings)
+// Field validation (preserve original key strings)
+static void validateStudent(const Student& s, std::vector<std::string>& err) {
     if (!StudentValidator::validName(s.name))               { err.push_back("Name"); }
     if (!StudentValidator::validStudentID(s.studentID))     { err.push_back("Student ID"); }
     if (!StudentValidator::validBirthYear(s.birthYear))     { err.push_back("Birth Year"); }
     if (!StudentValidator::validDepartment(s.department))   { err.push_back("Department"); }
     if (!StudentValidator::validTel(s.tel))                 { err.push_back("Tel"); }
     if (s.name.empty() || s.studentID.empty())              { err.push_back("Empty required"); }
+}
+
+bool StudentDB::insert(const Student& s, std::vector<std::string>& err) {
+    Metrics::ScopedTimer timer(MetricOp::Insert);
+    ensureAllYears();
+    // Pre-check for duplicate student ID/telephone (keep original behavior/message)
+    if (existsID(s.studentID)) { err.push_back("DUP_ID"); return false; }
+    if (existsTel(s.tel))      { err.push_back("DUP_TEL"); return false; }
+
+    validateStudent(s, err);
+
+    StudentRecord r;
+    if (err.empty() && !StudentRecord::from(s, r)) err.push_back("DEPT_FULL");
 
     if (err.empty()) {
-        data_.push_back(s);
+        data_.push_back(r);
+        indexRow(data_.size() - 1);
+        logInsert(data_.back());
         err.clear();
         return true;
     } else {
         return false;
     }
 }
+// ---------- BULK INSERTION ----------
+size_t StudentDB::insertMany(const std::vector<Student>& batch, BatchErrors& errors, bool persist) {
+    Metrics::ScopedTimer timer(MetricOp::InsertMany);
+    ensureAllYears();
+    // Keys accepted earlier in this batch
+    std::unordered_set<uint64_t> batchIDs, batchTels;
+    batchIDs.reserve(batch.size());
+    batchTels.reserve(batch.size());
+
+    // Field checks for the whole batch up front; the per-field error keys are
+    // only worked out for the rows that fail
+    std::vector<StudentFields> fields;
+    fields.reserve(batch.size());
+    for (const Student& s : batch) fields.push_back({ s.name, s.studentID, s.birthYear, s.department, s.tel });
+    std::vector<uint8_t> valid(batch.size());
+    StudentValidator::validateBatch(fields.data(), fields.size(), valid.data());
+
+    std::vector<StudentRecord> accepted;
+    accepted.reserve(batch.size());
+    for (size_t row = 0; row < batch.size(); ++row) {
+        const Student& s = batch[row];
+        std::vector<std::string> err;
+
+        // Same order of checks as insert(): duplicates first, then the fields
+        uint64_t id = 0, tel = 0;
+        bool hasID  = StudentRecord::packID(s.studentID, id);
+        bool hasTel = StudentRecord::packTel(s.tel, tel);
+        if (hasID && (idIndex_.count(id) || batchIDs.count(id)))            err.push_back("DUP_ID");
+        else if (hasTel && (telIndex_.count(tel) || batchTels.count(tel)))  err.push_back("DUP_TEL");
+        else if (!valid[row]) validateStudent(s, err);
+
+        StudentRecord r;
+        if (err.empty() && !StudentRecord::from(s, r)) err.push_back("DEPT_FULL");
+        if (!err.empty()) {
+            errors.emplace_back(row, std::move(err));
+            continue;
+        }
+        batchIDs.insert(id);
+        batchTels.insert(tel);
+        accepted.push_back(r);
+    }
+
+    data_.reserve(data_.size() + accepted.size());
+    idIndex_.reserve(data_.size() + accepted.size());
+    for (const auto& r : accepted) {
+        data_.push_back(r);
+        indexRow(data_.size() - 1);
+        logInsert(r);
+    }
+
+    if (persist && !accepted.empty()) save(); // one save for the whole batch
+    return accepted.size();
+}
+
 //  ---------- FRESHMAN INSERTION ----------
-bool StudentDB::insertFreshman(Student& s, std::vector<std::string>& err) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distrib(0, 999999); // create 6 digits in the range (0 ~ 999999)
-
-    const std::string admissionYear = "2025";
-    std::string newID;
-    
-    do {
-        std::stringstream ss;
-        ss << admissionYear << std::setw(6) << std::setfill('0') << distrib(gen);
-        newID = ss.str();
-    } while (existsID(newID));
-
-    s.studentID = newID;
+void StudentDB::setIDPolicy(IDPolicy p) { ids_.setPolicy(p); }
+IDPolicy StudentDB::idPolicy() const { return ids_.policy(); }
 
-    return insert(s, err);
+void StudentDB::trackIDYear(int year) {
+    if (ids_.tracks(year)) return;
+    ids_.track(year);
+    auto it = admissionRows_.find(year);
+    if (it == admissionRows_.end()) return;
+    for (size_t i : it->second) if (alive(i)) ids_.markUsed(data_[i].id);
+}
+
+// 10-digit text of a packed student ID
+static std::string idText(uint64_t id) {
+    std::string s(StudentRecord::ID_LEN, '0');
+    for (size_t i = s.size(); i-- > 0; id /= 10) s[i] = static_cast<char>('0' + id % 10);
+    return s;
+}
+
+bool StudentDB::insertFreshman(Student& s, std::vector<std::string>& err, int admissionYear) {
+    Metrics::ScopedTimer timer(MetricOp::InsertFreshman);
+    ensureAllYears();
+    trackIDYear(admissionYear);
+    uint64_t id = 0;
+    if (!ids_.allocate(admissionYear, id)) {
+        err.push_back("ID_FULL");
+        return false;
+    }
+
+    s.studentID = idText(id);
+    if (insert(s, err)) return true;
+    if (!idIndex_.count(id)) ids_.release(id);
+    s.studentID.clear();
+    return false;
+}
+
+size_t StudentDB::insertFreshmen(std::vector<Student>& batch, BatchErrors& errors, int admissionYear, bool persist) {
+    Metrics::ScopedTimer timer(MetricOp::InsertFreshmen);
+    ensureAllYears(); // the bitmap must see every stored ID of the year
+    trackIDYear(admissionYear);
+    std::vector<uint64_t> ids;
+    ids_.allocate(admissionYear, batch.size(), ids);
+
+    // Rows past the allocated IDs are left out of the batch and reported
+    std::vector<Student> rows(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(ids.size()));
+    for (size_t i = 0; i < rows.size(); ++i) {
+        rows[i].studentID = idText(ids[i]);
+    }
+    size_t before = errors.size();
+    size_t inserted = insertMany(rows, errors, persist);
+    for (size_t e = before; e < errors.size(); ++e) {
+        // Give back only serials no stored row holds (a DUP_ID means one does)
+        uint64_t id = ids[errors[e].first];
+        if (!idIndex_.count(id)) ids_.release(id);
+        rows[errors[e].first].studentID.clear();
+    }
+    for (size_t i = ids.size(); i < batch.size(); ++i) {
+        errors.emplace_back(i, std::vector<std::string>{ "ID_FULL" });
+        batch[i].studentID.clear();
+    }
+    for (size_t i = 0; i < rows.size(); ++i) batch[i].studentID = std::move(rows[i].studentID);
+    return inserted;
 }
 // ---------- SEARCH ----------
-std::vector<Student> StudentDB::searchByName(const std::string& key) const {
-    std::vector<Student> out;
+// Keyword search on one text field: candidates from the trigram index when the key
+// is long enough, otherwise a full scan; every hit is verified case-insensitively
+ResultView StudentDB::searchSubstring(const std::string& key, const TrigramIndex& idx,
+                                      std::string_view (StudentRecord::*field)() const) const {
+    std::vector<size_t> hits;
     auto k = toLower(key);
-    for (const auto& s : data_) {
-        if (toLower(s.name).find(k) != std::string::npos)
-            out.push_back(s);
+    if (useTrigrams_ && idx.candidates(k, hits)) {
+        hits.erase(std::remove_if(hits.begin(), hits.end(), [&](size_t i) {
+            return !alive(i) || !TrigramIndex::containsFolded((data_[i].*field)(), k);
+        }), hits.end());
+        return ResultView(data_, std::move(hits));
+    }
+    for (size_t i = 0; i < data_.size(); ++i) {
+        if (alive(i) && TrigramIndex::containsFolded((data_[i].*field)(), k)) hits.push_back(i);
     }
-    return out;
+    return ResultView(data_, std::move(hits));
 }
 
-std::vector<Student> StudentDB::searchByID(const std::string& id10) const {
-    std::vector<Student> out;
-    for (const auto& s : data_) {
-        if (s.studentID == id10) out.push_back(s);
+ResultView StudentDB::searchByName(const std::string& key) const {
+    Metrics::ScopedTimer timer(MetricOp::SearchByName);
+    ensureAllYears();
+    return searchSubstring(key, nameGrams_, &StudentRecord::name);
+}
+
+ResultView StudentDB::searchByID(const std::string& id10) const {
+    Metrics::ScopedTimer timer(MetricOp::SearchByID);
+    ensureYear(idYear(id10));
+    std::vector<size_t> hits;
+    size_t i = findByID(id10);
+    if (i != npos) hits.push_back(i);
+    return ResultView(data_, std::move(hits));
+}
+
+ResultView StudentDB::searchByAdmissionYear(int y) const {
+    Metrics::ScopedTimer timer(MetricOp::SearchByAdmissionYear);
+    ensureYear(y);
+    auto it = admissionRows_.find(y);
+    return ResultView(data_, it == admissionRows_.end() ? std::vector<size_t>() : liveRows(it->second));
+}
+
+ResultView StudentDB::searchByBirthYear(int y) const {
+    Metrics::ScopedTimer timer(MetricOp::SearchByBirthYear);
+    ensureAllYears();
+    auto it = birthRows_.find(y);
+    return ResultView(data_, it == birthRows_.end() ? std::vector<size_t>() : liveRows(it->second));
+}
+
+// The keyword is matched against each distinct department name once (a few hundred
+// at most), then the rows of the matching departments are collected from deptRows_
+ResultView StudentDB::searchByDepartmentKeyword(const std::string& kw) const {
+    Metrics::ScopedTimer timer(MetricOp::SearchByDepartment);
+    ensureAllYears();
+    std::vector<size_t> hits;
+    deptRowsFor(toLower(kw), hits);
+    return ResultView(data_, liveRows(std::move(hits)));
+}
+
+void StudentDB::deptMatches(const std::string& lowerKey, std::vector<uint16_t>& ids) const {
+    DepartmentDictionary::global().matching(lowerKey, ids);
+    // Names interned after the last row was indexed (by another StudentDB) have no rows here
+    ids.erase(std::remove_if(ids.begin(), ids.end(), [&](uint16_t d) {
+        return d >= deptRows_.size() || deptRows_[d].empty();
+    }), ids.end());
+}
+
+size_t StudentDB::deptCount(const std::string& lowerKey) const {
+    std::vector<uint16_t> ids;
+    deptMatches(lowerKey, ids);
+    size_t n = 0;
+    for (uint16_t d : ids) n += deptRows_[d].size();
+    return n;
+}
+
+void StudentDB::deptRowsFor(const std::string& lowerKey, std::vector<size_t>& out) const {
+    std::vector<uint16_t> ids;
+    deptMatches(lowerKey, ids);
+    size_t first = out.size();
+    for (uint16_t d : ids) out.insert(out.end(), deptRows_[d].begin(), deptRows_[d].end());
+    if (ids.size() > 1) std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end());
+}
+
+void StudentDB::setSubstringIndex(bool enabled) {
+    if (enabled == useTrigrams_) return;
+    useTrigrams_ = enabled;
+    nameGrams_.clear();
+    if (!enabled) return;
+    for (size_t i = 0; i < data_.size(); ++i) nameGrams_.add(i, data_[i].name());
+}
+
+bool StudentDB::substringIndex() const { return useTrigrams_; }
+
+// ---------- QUERY ----------
+size_t StudentDB::bucketCount(const std::map<int, std::vector<size_t>>& buckets, int from, int to) {
+    size_t n = 0;
+    for (auto it = buckets.lower_bound(from); it != buckets.end() && it->first <= to; ++it) n += it->second.size();
+    return n;
+}
+
+void StudentDB::bucketRows(const std::map<int, std::vector<size_t>>& buckets, int from, int to,
+                           std::vector<size_t>& out) {
+    size_t first = out.size(), spans = 0;
+    for (auto it = buckets.lower_bound(from); it != buckets.end() && it->first <= to; ++it, ++spans) {
+        out.insert(out.end(), it->second.begin(), it->second.end());
     }
-    return out;
+    if (spans > 1) std::sort(out.begin() + first, out.end()); // each bucket is sorted on its own
 }
 
-std::vector<Student> StudentDB::searchByAdmissionYear(int y) const {
-    std::vector<Student> out;
-    for (const auto& s : data_) {
-        int ay = std::stoi(s.studentID.substr(0,4)); // checked in load/insert part
-        if (ay == y) out.push_back(s);
+size_t StudentDB::planEstimate(const Query& q) const {
+    switch (q.kind()) {
+        case Query::Kind::IDEquals:
+            return (q.keyValid() && idIndex_.count(q.key())) ? 1 : 0;
+        case Query::Kind::AdmissionRange:
+            return bucketCount(admissionRows_, q.from(), q.to());
+        case Query::Kind::BirthRange:
+            return bucketCount(birthRows_, q.from(), q.to());
+        case Query::Kind::NameContains: {
+            if (!useTrigrams_) return npos;
+            size_t n = nameGrams_.estimate(q.text());
+            return n == SIZE_MAX ? npos : n;
+        }
+        case Query::Kind::DeptContains:
+            return deptCount(q.text());
+        case Query::Kind::And: {
+            // Any indexed conjunct bounds the result; take the smallest
+            size_t best = npos;
+            for (const auto& c : q.children()) best = std::min(best, planEstimate(c));
+            return best;
+        }
+        case Query::Kind::Or: {
+            // Every branch needs an index, otherwise one scan is cheaper
+            size_t sum = 0;
+            for (const auto& c : q.children()) {
+                size_t n = planEstimate(c);
+                if (n == npos) return npos;
+                sum += n;
+            }
+            return sum;
+        }
+        default:
+            return npos; // All, TelEquals: no positional index
     }
-    return out;
 }
 
-std::vector<Student> StudentDB::searchByBirthYear(int y) const {
-    std::vector<Student> out;
-    for (const auto& s : data_) {
-        if (s.birthYear == y) out.push_back(s);
+void StudentDB::planCandidates(const Query& q, std::vector<size_t>& out) const {
+    switch (q.kind()) {
+        case Query::Kind::IDEquals: {
+            if (!q.keyValid()) return;
+            auto it = idIndex_.find(q.key());
+            if (it != idIndex_.end()) out.push_back(it->second);
+            return;
+        }
+        case Query::Kind::AdmissionRange:
+            bucketRows(admissionRows_, q.from(), q.to(), out);
+            return;
+        case Query::Kind::BirthRange:
+            bucketRows(birthRows_, q.from(), q.to(), out);
+            return;
+        case Query::Kind::NameContains:
+            nameGrams_.candidates(q.text(), out);
+            return;
+        case Query::Kind::DeptContains:
+            deptRowsFor(q.text(), out);
+            return;
+        case Query::Kind::And: {
+            const Query* best = nullptr;
+            size_t bestN = npos;
+            for (const auto& c : q.children()) {
+                size_t n = planEstimate(c);
+                if (n < bestN) { bestN = n; best = &c; }
+            }
+            if (best) planCandidates(*best, out);
+            return;
+        }
+        case Query::Kind::Or: {
+            std::vector<size_t> part;
+            for (const auto& c : q.children()) {
+                part.clear();
+                planCandidates(c, part);
+                out.insert(out.end(), part.begin(), part.end());
+            }
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+            return;
+        }
+        default:
+            return;
     }
-    return out;
 }
 
-std::vector<Student> StudentDB::searchByDepartmentKeyword(const std::string& kw) const {
-    std::vector<Student> out;
-    auto k = toLower(kw);
-    for (const auto& s : data_) {
-        if (toLower(s.department).find(k) != std::string::npos)
-            out.push_back(s);
+ResultView StudentDB::find(const Query& q) const {
+    Metrics::ScopedTimer timer(MetricOp::Find);
+    ensureQueryYears(q);
+    std::vector<size_t> hits;
+    if (planEstimate(q) == npos) {
+        for (size_t i = 0; i < data_.size(); ++i) {
+            if (alive(i) && q.matches(data_[i])) hits.push_back(i);
+        }
+        return ResultView(data_, std::move(hits));
     }
-    return out;
+
+    // Candidates come from an index; the full predicate decides (short-circuit per row)
+    planCandidates(q, hits);
+    hits.erase(std::remove_if(hits.begin(), hits.end(), [&](size_t i) { return !alive(i) || !q.matches(data_[i]); }),
+               hits.end());
+    return ResultView(data_, std::move(hits));
 }
 
 // ---------- SORTING ----------
 void StudentDB::setSortKey(SortKey k) { sortKey_ = k; }
 SortKey StudentDB::sortKey() const { return sortKey_; }
 
-std::vector<Student>& StudentDB::sortByKey() {
-    switch (sortKey_) {
-        case SortKey::Name:
-            std::sort(data_.begin(), data_.end(), [](const Student& a, const Student& b){
-                return (a.name == b.name) ? a.studentID < b.studentID : a.name < b.name;
-            });
-            break;
-
+bool RowLess::operator()(size_t ia, size_t ib) const {
+    const StudentRecord& a = (*rows)[ia];
+    const StudentRecord& b = (*rows)[ib];
+    // IDs are fixed-width, so numeric order equals the old string order
+    switch (key) {
+        case SortKey::Name: {
+            int c = a.name().compare(b.name());
+            return (c == 0) ? a.id < b.id : c < 0;
+        }
         case SortKey::StudentID:
-            std::sort(data_.begin(), data_.end(), [](const Student& a, const Student& b){
-                return a.studentID < b.studentID;
-            });
-            break;
-
+            return a.id < b.id;
         case SortKey::BirthYear:
-            std::sort(data_.begin(), data_.end(), [](const Student& a, const Student& b){
-                return (a.birthYear == b.birthYear) ? a.studentID < b.studentID : a.birthYear < b.birthYear;
-            });
-            break;
-
-        case SortKey::Department:
-            std::sort(data_.begin(), data_.end(), [](const Student& a, const Student& b){
-                return (a.department == b.department) ? a.studentID < b.studentID : a.department < b.department;
-            });
-            break;
-        
+            return (a.birth == b.birth) ? a.id < b.id : a.birth < b.birth;
+        case SortKey::Department: {
+            // Dictionary ranks follow name order, so no text is compared
+            if (a.dept == b.dept) return a.id < b.id;
+            return DepartmentDictionary::global().less(a.dept, b.dept);
+        }
         default:
-            break;
+            return a.id < b.id;
+    }
+}
+
+SortedView StudentDB::sortByKey() const {
+    Metrics::ScopedTimer timer(MetricOp::SortByKey);
+    return sortedBy(sortKey_);
+}
+
+SortedView StudentDB::sortedBy(SortKey k) const {
+    Metrics::ScopedTimer timer(MetricOp::SortedBy);
+    ensureAllYears();
+    return SortedView(sorted_[static_cast<size_t>(k)]);
+}
+
+ResultView StudentDB::page(SortKey k, size_t offset, size_t limit) const {
+    Metrics::ScopedTimer timer(MetricOp::Page);
+    ensureAllYears();
+    size_t key = static_cast<size_t>(k);
+    std::lock_guard<std::mutex> lock(orderMutex_);
+    auto& order = order_[key];
+    if (!orderValid_[key]) {
+        // Set iterators cannot seek by rank: copy the order once, then every page is a slice
+        order.assign(sorted_[key].begin(), sorted_[key].end());
+        orderValid_[key] = true;
     }
-    return data_;
+    if (offset >= order.size()) return ResultView(data_, std::vector<size_t>());
+    auto first = order.begin() + static_cast<std::ptrdiff_t>(offset);
+    auto last  = first + static_cast<std::ptrdiff_t>(std::min(limit, order.size() - offset));
+    return ResultView(data_, std::vector<size_t>(first, last));
+}
+
+ResultView StudentDB::page(const ResultView& results, SortKey k, size_t offset, size_t limit) const {
+    Metrics::ScopedTimer timer(MetricOp::Page);
+    std::vector<size_t> rows = results.positions();
+    if (offset >= rows.size()) return ResultView(data_, std::vector<size_t>());
+    auto first = rows.begin() + static_cast<std::ptrdiff_t>(offset);
+    auto last  = rows.begin() + static_cast<std::ptrdiff_t>(offset + std::min(limit, rows.size() - offset));
+    RowLess less{&data_, k};
+    if (offset > 0) std::nth_element(rows.begin(), first, rows.end(), less); // rows before the page, unsorted
+    std::partial_sort(first, last, rows.end(), less);
+    return ResultView(data_, std::vector<size_t>(first, last));
 }
 
 // ---------- UPDATE ----------
 bool StudentDB::updateName(const std::string& studentID, const std::string& newName, std::string& err) {
+    Metrics::ScopedTimer timer(MetricOp::UpdateName);
+    ensureYear(idYear(studentID));
     if (!StudentValidator::validName(newName)) { err = "Name"; return false; }
-    for (auto& s : data_) {
-        if (s.studentID == studentID) {
-            s.name = newName;
-            err.clear(); return true;
-        }
-    }
-    err = "Not found"; return false;
+    size_t i = findByID(studentID);
+    if (i == npos) { err = "Not found"; return false; }
+    auto& idx = sorted_[static_cast<size_t>(SortKey::Name)];
+    idx.erase(i);              // re-position under the new key
+    if (useTrigrams_) nameGrams_.remove(i, data_[i].name());
+    data_[i].setName(newName);
+    idx.insert(i);
+    invalidateOrder(SortKey::Name);
+    if (useTrigrams_) nameGrams_.add(i, newName);
+    logUpdate("NAME", studentID, newName);
+    err.clear(); return true;
 }
 
 bool StudentDB::updateDepartment(const std::string& studentID, const std::string& newDept, std::string& err) {
+    Metrics::ScopedTimer timer(MetricOp::UpdateDepartment);
+    ensureYear(idYear(studentID));
     if (!StudentValidator::validDepartment(newDept)) { err = "Department"; return false; }
-    for (auto& s : data_) {
-        if (s.studentID == studentID) {
-            s.department = newDept;
-            err.clear(); return true;
-        }
-    }
-    err = "Not found"; return false;
+    size_t i = findByID(studentID);
+    if (i == npos) { err = "Not found"; return false; }
+    StudentRecord updated = data_[i];
+    if (!updated.setDepartment(newDept)) { err = "DEPT_FULL"; return false; }
+    auto& idx = sorted_[static_cast<size_t>(SortKey::Department)];
+    idx.erase(i);
+    auto& oldRows = deptRows_[data_[i].dept];
+    oldRows.erase(std::lower_bound(oldRows.begin(), oldRows.end(), i));
+    stats_.remove(data_[i].admissionYear(), data_[i].birthYear(), data_[i].dept);
+    data_[i].dept = updated.dept;
+    stats_.add(data_[i].admissionYear(), data_[i].birthYear(), data_[i].dept);
+    idx.insert(i);
+    invalidateOrder(SortKey::Department);
+    if (data_[i].dept >= deptRows_.size()) deptRows_.resize(data_[i].dept + size_t{1});
+    auto& newRows = deptRows_[data_[i].dept];
+    newRows.insert(std::lower_bound(newRows.begin(), newRows.end(), i), i);
+    logUpdate("DEPT", studentID, newDept);
+    err.clear(); return true;
 }
 
 bool StudentDB::updateTel(const std::string& studentID, const std::string& newTel, std::string& err) {
+    Metrics::ScopedTimer timer(MetricOp::UpdateTel);
+    ensureAllYears();
     if (!StudentValidator::validTel(newTel)) { err = "Telephone number"; return false; }
     if (existsTel(newTel)) { err = "\nTelephone number already exists.\n\n"; return false; }
-    for (auto& s : data_) {
-        if (s.studentID == studentID) {
-            s.tel = newTel;
-            err.clear(); return true;
-        }
-    }
-    err = "Not found"; return false;
+    size_t i = findByID(studentID);
+    if (i == npos) { err = "Not found"; return false; }
+    telIndex_.erase(telIndex_.find(data_[i].telKey())); // drop one occurrence of the old number
+    data_[i].setTel(newTel);
+    telIndex_.insert(data_[i].telKey());
+    logUpdate("TEL", studentID, newTel);
+    err.clear(); return true;
 }
-// Internal Tree Node
-struct __StatsNode {
-    std::map<std::string, __StatsNode> children; // child groups
-    int count = 0;                               // total count of this node (group)
-};
 
-// Output label (for display formatting)
-static std::string __labelOf(StatKey key, const std::string& v) {
-    switch (key) {
-        case StatKey::AdmissionYear: return v + "Admission";   // ex) "2025 Admission"
-        case StatKey::BirthYear:     return v + "Born";   // ex) "2005 Born"
-        case StatKey::Department:    return v;            // Department Name
-        default:                     return v;
-    }
+// ---------- DELETION ----------
+// The row stays in data_ (positions of the other rows do not change). Indexes that
+// answer "does it exist" or count rows forget it now; the bucket and trigram entries
+// stay until compact() and are filtered with alive().
+void StudentDB::removeRow(size_t i) {
+    const StudentRecord& r = data_[i];
+    for (auto& idx : sorted_) idx.erase(i);
+    invalidateOrder();
+    idIndex_.erase(r.id);
+    telIndex_.erase(telIndex_.find(r.telKey()));
+    // ids_ keeps the ID marked used: student IDs are never reissued
+    stats_.remove(r.admissionYear(), r.birthYear(), r.dept);
+    if (dead_.size() < data_.size()) dead_.resize(data_.size(), 0);
+    dead_[i] = 1;
+    ++deadCount_;
+    logRemove(r);
 }
 
-// Extract the key value from a student record
-static std::string __valueOf(const Student& s, StatKey key) {
-    switch (key) {
-        case StatKey::AdmissionYear:
-            if (s.studentID.size() >= 4) {
-                try { return s.studentID.substr(0,4); } catch (...) { return "????"; }
-            }
-            return "????";
-        case StatKey::BirthYear:
-            return std::to_string(s.birthYear);
-        case StatKey::Department:
-            return s.department;
-        default:
-            return "";
-    }
+const std::vector<StudentRecord>& StudentDB::liveRecords(std::vector<StudentRecord>& scratch) const {
+    if (deadCount_ == 0) return data_;
+    scratch.reserve(data_.size() - deadCount_);
+    for (size_t i = 0; i < data_.size(); ++i) if (alive(i)) scratch.push_back(data_[i]);
+    return scratch;
 }
 
-// Recursive printing of the hierarchical tree
-static void __printTree(const __StatsNode& node,
-                        const std::vector<StatKey>& order,
-                        size_t depth,
-                        std::ostream& out,
-                        const std::string& prefix)
-{
-    if (depth >= order.size() || node.children.empty()) {
-        return;
-    }
-
-    StatKey currentKey = order[depth];
-    auto it = node.children.begin();
-    while (it != node.children.end()) {
-        const auto& key = it->first;
-        const auto& childNode = it->second;
-        
-        bool isLast = (++it == node.children.end());
+std::vector<size_t> StudentDB::liveRows(std::vector<size_t> rows) const {
+    if (deadCount_ == 0) return rows;
+    rows.erase(std::remove_if(rows.begin(), rows.end(), [this](size_t i) { return !alive(i); }), rows.end());
+    return rows;
+}
 
-        out << prefix << "+-- " << __labelOf(currentKey, key) << " (" << childNode.count << ")\n";
+bool StudentDB::remove(const std::string& studentID, std::string& err) {
+    Metrics::ScopedTimer timer(MetricOp::Remove);
+    ensureYear(idYear(studentID));
+    size_t i = findByID(studentID);
+    if (i == npos) { err = "Not found"; return false; }
+    removeRow(i);
+    maybeCompact();
+    err.clear(); return true;
+}
 
-        std::string nextPrefix = prefix + (isLast ? "    " : "|   ");
-        // Recursively call the function for child nodes
-        __printTree(childNode, order, depth + 1, out, nextPrefix);
+size_t StudentDB::removeMany(const std::vector<std::string>& ids, BatchErrors& errors, bool persist) {
+    Metrics::ScopedTimer timer(MetricOp::RemoveMany);
+    size_t removed = 0;
+    for (size_t k = 0; k < ids.size(); ++k) {
+        ensureYear(idYear(ids[k]));
+        size_t i = findByID(ids[k]);
+        if (i == npos) {
+            errors.emplace_back(k, std::vector<std::string>{ "NOT_FOUND" });
+            continue;
+        }
+        removeRow(i);
+        ++removed;
     }
+    maybeCompact();
+    if (persist && removed > 0) save();
+    return removed;
+}
+
+size_t StudentDB::removeWhere(const Query& q, bool persist) {
+    Metrics::ScopedTimer timer(MetricOp::RemoveMany);
+    std::vector<size_t> rows = find(q).positions();
+    for (size_t i : rows) removeRow(i);
+    maybeCompact();
+    if (persist && !rows.empty()) save();
+    return rows.size();
 }
 
+void StudentDB::maybeCompact() {
+    if (deadCount_ >= COMPACT_MIN && deadCount_ * 4 >= data_.size()) compact();
+}
+
+// Same path as a load: the live rows are moved to a fresh vector and every index
+// is built in bulk (in parallel), which costs less than unindexing row by row
+void StudentDB::compact() {
+    if (deadCount_ == 0) return;
+    Metrics::ScopedTimer timer(MetricOp::Compact);
+    std::vector<std::vector<StudentRecord>> parts(1);
+    liveRecords(parts[0]);
+
+    std::vector<StudentRecord>().swap(data_);
+    std::vector<uint8_t>().swap(dead_);
+    deadCount_ = 0;
+    StudentIDAllocator ids = std::move(ids_); // still holds the removed IDs as used
+    clearIndexes();
+
+    unsigned workers = loadThreads_;
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    mergeParts(parts, workers);
+    ids_ = std::move(ids);
+}
+// ---------- STATISTICS ----------
 // Public API: print hierarchical summary statistics
 void StudentDB::groupSummary(const std::vector<StatKey>& order, std::ostream& out) const {
+    Metrics::ScopedTimer timer(MetricOp::GroupSummary);
+    ensureAllYears();
     if (order.empty()) {
-        out << "Total (" << data_.size() << ")\n\n";
+        out << "Total (" << data_.size() - deadCount_ << ")\n\n";
         return;
     }
-
-    __StatsNode root;
-    root.count = static_cast<int>(data_.size());
-
-    for (const auto& s : data_) {
-        __StatsNode* cur = &root;
-        for (StatKey k : order) {
-            std::string key = __valueOf(s, k);
-            cur = &cur->children[key];
-            cur->count += 1;
-        }
-    }
-
-    out << "Total (" << root.count << ")\n";
-    
-    __printTree(root, order, 0, out, ""); // initial prefix is empty
-    
+    stats_.print(order, out);
     out << '\n';
 }
@@ -2,67 +2,371 @@
 #define STUDENT_DB_HPP
 
 #include "Student.hpp"
+#include "StudentRecord.hpp"
 #include "StudentValidator.hpp"
 #include "FileStudentRepository.hpp"
+#include "TrigramIndex.hpp"
+#include "Journal.hpp"
+#include "Query.hpp"
+#include "Metrics.hpp"
+#include "StatsCube.hpp"
+#include "DepartmentDictionary.hpp"
+#include "StudentIDAllocator.hpp"
+#include "PartitionedStudentRepository.hpp"
 #include <vector>
 #include <string>
 #include <map>
+#include <mutex>
+#include <set>
+#include <array>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
 #include <ostream> 
 
 enum class SortKey { Name, StudentID, BirthYear, Department };
-enum class StatKey { AdmissionYear, BirthYear, Department };
+
+// Rewrite: save() rewrites the whole file.
+// Journal: save() appends the changes since the last save to <file>.wal and the
+//          file itself is only rewritten at checkpoints.
+// Partitioned: one file per admission year in <file>.parts/ (split from <file> on
+//          first use). Years are loaded when a call needs them and save() rewrites
+//          only the years that changed.
+enum class Persistence { Rewrite, Journal, Partitioned };
+
+// Strict ordering of row positions by one SortKey (ties broken by student ID, which is unique)
+struct RowLess {
+    const std::vector<StudentRecord>* rows;
+    SortKey                           key;
+    bool operator()(size_t a, size_t b) const;
+};
+
+// Read-only view over the students in sorted order (no copy).
+// Valid until the next insertion/update/removal on the database it came from.
+class SortedView {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = StudentRecord;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const StudentRecord*;
+        using reference         = const StudentRecord&;
+
+        iterator(std::set<size_t, RowLess>::const_iterator it, const std::vector<StudentRecord>* rows)
+        : it_(it), rows_(rows) {}
+
+        reference operator*()  const { return (*rows_)[*it_]; }
+        pointer   operator->() const { return &(*rows_)[*it_]; }
+        iterator& operator++() { ++it_; return *this; }
+        iterator& operator--() { --it_; return *this; }
+        bool operator==(const iterator& o) const { return it_ == o.it_; }
+        bool operator!=(const iterator& o) const { return it_ != o.it_; }
+
+    private:
+        std::set<size_t, RowLess>::const_iterator it_;
+        const std::vector<StudentRecord>*         rows_;
+    };
+
+    explicit SortedView(const std::set<size_t, RowLess>& index) : index_(&index) {}
+
+    iterator begin() const { return iterator(index_->begin(), index_->key_comp().rows); }
+    iterator end()   const { return iterator(index_->end(),   index_->key_comp().rows); }
+    size_t   size()  const { return index_->size(); }
+    bool     empty() const { return index_->empty(); }
+
+private:
+    const std::set<size_t, RowLess>* index_;
+};
+
+// Search result: positions of the matching rows in the database (no student copies).
+// Valid until the next insertion/update/removal on the database it came from.
+class ResultView {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = StudentRecord;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const StudentRecord*;
+        using reference         = const StudentRecord&;
+
+        iterator(std::vector<size_t>::const_iterator it, const std::vector<StudentRecord>* rows)
+        : it_(it), rows_(rows) {}
+
+        reference operator*()  const { return (*rows_)[*it_]; }
+        pointer   operator->() const { return &(*rows_)[*it_]; }
+        iterator& operator++() { ++it_; return *this; }
+        iterator& operator--() { --it_; return *this; }
+        iterator& operator+=(difference_type n) { it_ += n; return *this; }
+        iterator  operator+(difference_type n) const { return iterator(it_ + n, rows_); }
+        difference_type operator-(const iterator& o) const { return it_ - o.it_; }
+        bool operator==(const iterator& o) const { return it_ == o.it_; }
+        bool operator!=(const iterator& o) const { return it_ != o.it_; }
+
+    private:
+        std::vector<size_t>::const_iterator it_;
+        const std::vector<StudentRecord>*   rows_;
+    };
+
+    ResultView(const std::vector<StudentRecord>& rows, std::vector<size_t> hits)
+    : rows_(&rows), hits_(std::move(hits)) {}
+
+    iterator begin() const { return iterator(hits_.begin(), rows_); }
+    iterator end()   const { return iterator(hits_.end(),   rows_); }
+    size_t   size()  const { return hits_.size(); }
+    bool     empty() const { return hits_.empty(); }
+    const StudentRecord& operator[](size_t i) const { return (*rows_)[hits_[i]]; }
+
+    const std::vector<size_t>& positions() const { return hits_; }
+
+    // Explicit copy for callers that need to keep the results past the next change
+    std::vector<Student> toStudents() const {
+        std::vector<Student> out;
+        out.reserve(hits_.size());
+        for (size_t i : hits_) out.push_back((*rows_)[i].toStudent());
+        return out;
+    }
+
+private:
+    const std::vector<StudentRecord>* rows_;
+    std::vector<size_t>               hits_;
+};
 
 class StudentDB {
 public:
     explicit StudentDB(const std::string& path);
 
-    // Load/Save
+    // Deep copy: the sorted indexes of the copy refer to its own rows. Used to
+    // publish new versions in ConcurrentStudentDB. Not assignable.
+    StudentDB(const StudentDB& other);
+    StudentDB& operator=(const StudentDB&) = delete;
+
+    // Load/Save (load() also replays a leftover journal)
     bool load();
-    bool save() const;
+    bool save();
+
+    // Journaled persistence
+    void        setPersistence(Persistence p);
+    Persistence persistence() const;
+    void        setCheckpointBytes(uint64_t n);  // journal size that triggers a checkpoint in save()
+    bool        checkpoint();                    // rewrite the file and clear the journal
+
+    // Partitioned persistence: searches by ID or admission year, compound queries
+    // bounded by those, and name/department updates load only the years involved.
+    // Everything else (other searches, sorting, statistics, insertion, tel checks)
+    // loads every year. Loading invalidates earlier views like an insertion does,
+    // so a database shared between threads must load everything up front.
+    void        loadAllPartitions();
+
+    // Writes the current data to another file; a ".sdb" name gives a binary snapshot,
+    // anything else the text format. load() reads either format (detected by header).
+    bool exportTo(const std::string& path) const;
+
+    // Worker threads used by load() (0 = one per hardware thread, 1 = single-threaded)
+    void     setLoadThreads(unsigned n);
+    unsigned loadThreads() const;
 
     // check if empty
-    bool isEmpty() const;
+    bool   isEmpty() const;
+    size_t size() const;
 
     // Insertion(duplicate StudentId/Tel check)
     bool insert(const Student& s); // wrapper for convinience
     bool insert(const Student& s, std::vector<std::string>& err);
     
-    // Function for Freshman Insertion
-    bool insertFreshman(Student& s, std::vector<std::string>& err);
-
-    // Search
-    std::vector<Student> searchByName(const std::string& key) const;      
-    std::vector<Student> searchByID(const std::string& id10) const;        
-    std::vector<Student> searchByAdmissionYear(int year4) const;          
-    std::vector<Student> searchByBirthYear(int year4) const;                
-    std::vector<Student> searchByDepartmentKeyword(const std::string& kw) const; 
-
-    // Sorting Option
-    std::vector<Student>& sortByKey();
+    // Bulk insertion: one pass checks every row against the database and the rows
+    // accepted before it in the same batch, with the same error keys as insert().
+    // Rejected rows are reported as (index in batch, error keys). Accepted rows are
+    // added together and, if persist is true, saved once at the end.
+    using BatchErrors = std::vector<std::pair<size_t, std::vector<std::string>>>;
+    size_t insertMany(const std::vector<Student>& batch, BatchErrors& errors, bool persist = true);
+
+    // Freshman insertion: s.studentID is set to an unused ID of admissionYear. If the
+    // insertion fails the ID is given back and s.studentID cleared. Extra error key:
+    // "ID_FULL" when the year has no free serial (or is out of range).
+    static constexpr int FRESHMAN_YEAR = 2025;
+    bool insertFreshman(Student& s, std::vector<std::string>& err, int admissionYear = FRESHMAN_YEAR);
+    // Batch version: IDs for the whole batch are allocated at once, then the rows go
+    // through insertMany(). Rejected rows get their studentID cleared.
+    size_t insertFreshmen(std::vector<Student>& batch, BatchErrors& errors,
+                          int admissionYear = FRESHMAN_YEAR, bool persist = true);
+
+    // How freshman serials are picked (Random by default)
+    void     setIDPolicy(IDPolicy p);
+    IDPolicy idPolicy() const;
+
+    // Search (results are views over the stored rows, in insertion order)
+    ResultView searchByName(const std::string& key) const;      
+    ResultView searchByID(const std::string& id10) const;        
+    ResultView searchByAdmissionYear(int year4) const;          
+    ResultView searchByBirthYear(int year4) const;                
+    ResultView searchByDepartmentKeyword(const std::string& kw) const; 
+
+    // Compound search: picks the most selective index for q (ID lookup, year buckets,
+    // trigram candidates) and checks the whole predicate on those candidates only.
+    // Falls back to one scan when some OR branch has no usable index.
+    ResultView find(const Query& q) const;
+
+    // Trigram index for name keyword search (on by default). Turning it off frees
+    // the index and falls back to a full scan. Department keywords always go through
+    // the department dictionary and deptRows_.
+    void setSubstringIndex(bool enabled);
+    bool substringIndex() const;
+
+    // Sorting Option (data_ itself is never reordered; the views read the sorted indexes)
+    SortedView sortByKey() const;              // view in the current sort key order
+    SortedView sortedBy(SortKey k) const;
     void setSortKey(SortKey k);
     SortKey sortKey() const;
 
+    // Paging: rows [offset, offset + limit) in key order. The whole-table version copies
+    // the page out of a rank array of the sorted index: O(limit), plus one O(n) rebuild
+    // of that array for the first page after a change to the key's order. The result
+    // version selects the page (nth_element + partial_sort) from the hits of a search
+    // on this database: O(hits + limit log limit). Safe to call from several threads.
+    ResultView page(SortKey k, size_t offset, size_t limit) const;
+    ResultView page(const ResultView& results, SortKey k, size_t offset, size_t limit) const;
+    ResultView topK(SortKey k, size_t limit) const { return page(k, 0, limit); }
+
     // Update
     bool updateName(const std::string& studentID, const std::string& newName, std::string& err);
     bool updateDepartment(const std::string& studentID, const std::string& newDept, std::string& err);
     bool updateTel(const std::string& studentID, const std::string& newTel, std::string& err);
 
+    // Deletion: the row is tombstoned in place and taken out of the ID, tel and sorted
+    // indexes and the statistics (O(log n), no row moves). Year, department and name
+    // index entries of tombstoned rows are skipped by searches until compact(). The
+    // student ID is not handed out again by insertFreshman() in this session (the
+    // files keep no record of removed IDs). Error: "Not found".
+    bool remove(const std::string& studentID, std::string& err);
+    // Bulk deletion (e.g. a graduating cohort: removeWhere(Query::admissionYear(y, y))),
+    // saved once at the end if persist is true. Unknown IDs are reported as
+    // (index in ids, {"NOT_FOUND"}).
+    size_t removeMany(const std::vector<std::string>& ids, BatchErrors& errors, bool persist = true);
+    size_t removeWhere(const Query& q, bool persist = true);
+
+    // Drops the tombstoned rows from data_ and rebuilds the indexes in bulk. Runs by
+    // itself once tombstones reach a quarter of the rows (at least COMPACT_MIN).
+    // Saves never write tombstoned rows, so compacting changes no file.
+    // Invalidates views like an insertion.
+    static constexpr size_t COMPACT_MIN = 1024;
+    void   compact();
+    size_t tombstones() const { return deadCount_; }
+
+    // Grouped counts (Statistics), answered from the statistics cube
     void groupSummary(const std::vector<StatKey>& order, std::ostream& out) const;
 
 private:
     static std::string toLower(std::string s);  // convert to small letter
 
-    bool existsID(const std::string& ID) const;
-    bool existsTel(const std::string& Tel) const;
+    bool existsID(std::string_view ID) const;
+    bool existsTel(std::string_view Tel) const;
+
+    // Makes ids_ track `year`, marking the IDs already stored for it
+    void trackIDYear(int year);
+
+    // Partitioned persistence: load the years a call needs (no-op in the other modes).
+    // Called from const queries: loading only adds rows, like a lazy cache fill.
+    void ensureYear(int year) const;
+    void ensureAllYears() const;
+    void ensureQueryYears(const Query& q) const;
+    void loadPartitions(const std::vector<int>& years);
+    bool savePartitions();
+
+    // Hash index helpers
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    size_t findByID(std::string_view ID) const;    // position in data_, or npos
+    void   indexRow(size_t i);                     // register data_[i] in the hash and sorted indexes
+    void   clearIndexes();
+    void   buildIndexes(unsigned workers);         // bulk build of every index but idIndex_
+    void   mergeParts(std::vector<std::vector<StudentRecord>>& parts, unsigned workers);
+    // Tombstones
+    bool alive(size_t i) const { return i >= dead_.size() || !dead_[i]; }
+    void removeRow(size_t i);                     // tombstone data_[i] and unindex it
+    void maybeCompact();
+    std::vector<size_t> liveRows(std::vector<size_t> rows) const;   // drops tombstoned positions
+    // data_ itself, or the live rows copied into scratch when there are tombstones
+    const std::vector<StudentRecord>& liveRecords(std::vector<StudentRecord>& scratch) const;
+    // Journal helpers
+    void logInsert(const StudentRecord& r);
+    void logRemove(const StudentRecord& r);
+    void logUpdate(const char* tag, std::string_view id, std::string_view value);
+    void replayLine(std::string_view line);
+
+    // Query planning: estimated rows from the cheapest index path (npos = needs a scan),
+    // and the matching candidate positions (sorted, unique) from that path
+    size_t planEstimate(const Query& q) const;
+    void   planCandidates(const Query& q, std::vector<size_t>& out) const;
+    static size_t bucketCount(const std::map<int, std::vector<size_t>>& buckets, int from, int to);
+    static void   bucketRows(const std::map<int, std::vector<size_t>>& buckets, int from, int to,
+                             std::vector<size_t>& out);
+    // Department IDs whose name contains lowerKey, and their rows (sorted)
+    void   deptMatches(const std::string& lowerKey, std::vector<uint16_t>& ids) const;
+    size_t deptCount(const std::string& lowerKey) const;
+    void   deptRowsFor(const std::string& lowerKey, std::vector<size_t>& out) const;
+
+    ResultView searchSubstring(const std::string& key, const TrigramIndex& idx,
+                               std::string_view (StudentRecord::*field)() const) const;
 
     // Internal state
     std::string                 path_;
-    std::vector<Student>        data_;
+    std::vector<StudentRecord>  data_;                   // compact rows, insertion order
+    std::vector<uint8_t>        dead_;                   // 1 = tombstoned row (rows past the end are alive)
+    size_t                      deadCount_{0};
     SortKey                     sortKey_{SortKey::Name}; // Default
+    unsigned                    loadThreads_{0};
+
+    // Persistence state
+    Persistence                 persistence_{Persistence::Rewrite};
+    uint64_t                    checkpointBytes_{1u << 20};
+    std::string                 pending_;             // journal lines not yet saved
+    bool                        replaying_{false};    // true while load() replays the journal
+    PartitionedStudentRepository partitions_;         // Persistence::Partitioned storage
+    std::set<int>               loadedYears_;         // partitions already in data_
+    std::set<int>               dirtyYears_;          // partitions changed since the last save
+
+    // Hash indexes, kept in sync with data_ by load/insert/update
+    std::unordered_map<uint64_t, size_t>    idIndex_;     // packed studentID -> position in data_
+    std::unordered_multiset<uint64_t>       telIndex_;    // StudentRecord::telKey() (the file may hold duplicates)
+
+    // Year buckets: rows per admission year / birth year (both immutable after insert)
+    std::map<int, std::vector<size_t>> admissionRows_;
+    std::map<int, std::vector<size_t>> birthRows_;
+    // Rows per department, indexed by DepartmentDictionary ID (each bucket sorted)
+    std::vector<std::vector<size_t>>   deptRows_;
+
+    // Used serials per admission year, for freshman IDs (years tracked on first use)
+    StudentIDAllocator          ids_;
+
+    // AdmissionYear x BirthYear x Department counts for groupSummary()
+    StatsCube                   stats_;
+
+    // Substring (trigram) index over name
+    bool                        useTrigrams_{true};
+    TrigramIndex                nameGrams_;
+
+    // One sorted index per SortKey, updated in O(log n) on insert/update
+    static constexpr size_t SORT_KEY_COUNT = 4;
+    std::array<std::set<size_t, RowLess>, SORT_KEY_COUNT> sorted_{{
+        std::set<size_t, RowLess>(RowLess{&data_, SortKey::Name}),
+        std::set<size_t, RowLess>(RowLess{&data_, SortKey::StudentID}),
+        std::set<size_t, RowLess>(RowLess{&data_, SortKey::BirthYear}),
+        std::set<size_t, RowLess>(RowLess{&data_, SortKey::Department}),
+    }};
+    // sorted_[k] as an array (rank -> row) for page(); rebuilt by the first page()
+    // after invalidateOrder(k). Guarded by orderMutex_ (page() is const and may run
+    // on several reader threads); never copied.
+    mutable std::mutex                                      orderMutex_;
+    mutable std::array<std::vector<size_t>, SORT_KEY_COUNT> order_;
+    mutable std::array<bool, SORT_KEY_COUNT>                orderValid_{};
+    void invalidateOrder()          { orderValid_.fill(false); }
+    void invalidateOrder(SortKey k) { orderValid_[static_cast<size_t>(k)] = false; }
 
     // Separated components
     StudentValidator            validator_;           // Stateless: safe to hold as an instance
     FileStudentRepository       repository_;          // Responsible for file I/O
+    Journal                     journal_;             // Change log for Persistence::Journal
 };
 
 #endif // STUDENT_DB_HPP
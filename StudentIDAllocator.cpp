@@ -0,0 +1,98 @@
+#include "StudentIDAllocator.hpp"
+#include "StudentValidator.hpp"
+
+StudentIDAllocator::StudentIDAllocator(uint32_t seed) : rng_(seed) {}
+
+void StudentIDAllocator::track(int year) {
+    years_.try_emplace(year);
+}
+
+void StudentIDAllocator::set(Year& y, uint32_t s) {
+    uint64_t bit = uint64_t{1} << (s & 63);
+    if (y.used[s >> 6] & bit) return;
+    y.used[s >> 6] |= bit;
+    ++y.count;
+}
+
+void StudentIDAllocator::markUsed(uint64_t id) {
+    auto it = years_.find(static_cast<int>(id / SERIALS));
+    if (it != years_.end()) set(it->second, static_cast<uint32_t>(id % SERIALS));
+}
+
+void StudentIDAllocator::release(uint64_t id) {
+    auto it = years_.find(static_cast<int>(id / SERIALS));
+    if (it == years_.end()) return;
+    Year& y = it->second;
+    uint32_t s = static_cast<uint32_t>(id % SERIALS);
+    if (!test(y, s)) return;
+    y.used[s >> 6] &= ~(uint64_t{1} << (s & 63));
+    --y.count;
+    if (s < y.cursor) y.cursor = s;
+    if (y.pooled) y.pool.push_back(s);
+}
+
+void StudentIDAllocator::clear() {
+    years_.clear();
+}
+
+// ---------- ALLOCATION ----------
+bool StudentIDAllocator::nextSequential(Year& y, uint32_t& serial) {
+    for (size_t w = y.cursor >> 6; w < WORDS; ++w) {
+        uint64_t freeBits = ~y.used[w];
+        if (w == (y.cursor >> 6)) freeBits &= ~uint64_t{0} << (y.cursor & 63); // below the cursor
+        if (freeBits == 0) continue;
+        uint32_t s = static_cast<uint32_t>(w * 64 + static_cast<size_t>(__builtin_ctzll(freeBits)));
+        if (s >= SERIALS) break; // padding bits of the last word
+        serial = s;
+        y.cursor = s + 1;
+        return true;
+    }
+    y.cursor = SERIALS;
+    return false;
+}
+
+bool StudentIDAllocator::nextRandom(Year& y, uint32_t& serial) {
+    if (!y.pooled) {
+        y.pool.reserve(SERIALS - y.count);
+        for (uint32_t s = 0; s < SERIALS; ++s) if (!test(y, s)) y.pool.push_back(s);
+        y.pooled = true;
+    }
+    while (!y.pool.empty()) {
+        std::uniform_int_distribution<size_t> pick(0, y.pool.size() - 1);
+        size_t k = pick(rng_);
+        uint32_t s = y.pool[k];
+        y.pool[k] = y.pool.back();
+        y.pool.pop_back();
+        if (test(y, s)) continue; // used since the pool was built
+        serial = s;
+        return true;
+    }
+    return false;
+}
+
+bool StudentIDAllocator::allocate(int year, uint64_t& id) {
+    std::vector<uint64_t> one;
+    if (allocate(year, 1, one) != 1) return false;
+    id = one[0];
+    return true;
+}
+
+size_t StudentIDAllocator::allocate(int year, size_t n, std::vector<uint64_t>& out) {
+    if (!StudentValidator::validAdmissionYear(year)) return 0;
+    Year& y = years_[year];
+    size_t done = 0;
+    for (; done < n && y.count < SERIALS; ++done) {
+        uint32_t s = 0;
+        bool ok = (policy_ == IDPolicy::Sequential) ? nextSequential(y, s) : nextRandom(y, s);
+        if (!ok) break;
+        set(y, s);
+        out.push_back(static_cast<uint64_t>(year) * SERIALS + s);
+    }
+    return done;
+}
+
+size_t StudentIDAllocator::available(int year) const {
+    if (!StudentValidator::validAdmissionYear(year)) return 0;
+    auto it = years_.find(year);
+    return it == years_.end() ? SERIALS : SERIALS - it->second.count;
+}
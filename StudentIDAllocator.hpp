@@ -0,0 +1,65 @@
+#ifndef STUDENT_ID_ALLOCATOR_HPP
+#define STUDENT_ID_ALLOCATOR_HPP
+
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Random: any free serial, uniformly. Sequential: the lowest free serial.
+enum class IDPolicy { Random, Sequential };
+
+// Hands out unused student IDs (4-digit admission year + 6-digit serial).
+// Each tracked year keeps a bitmap of used serials, which is the source of truth:
+//  - Sequential keeps a cursor below which every serial is used and skips full
+//    64-bit words, so it never revisits a serial (amortized O(1)).
+//  - Random draws from a pool of free serials (built on first use, swap-and-pop).
+//    Serials marked used after the pool was built are dropped when drawn, so each
+//    stale entry costs one extra draw at most (amortized O(1)).
+// IDs are packed like StudentRecord::id (year * 1000000 + serial).
+class StudentIDAllocator {
+public:
+    static constexpr uint32_t SERIALS = 1000000;   // 6-digit serials per admission year
+
+    explicit StudentIDAllocator(uint32_t seed = std::random_device{}());
+
+    void     setPolicy(IDPolicy p) { policy_ = p; }
+    IDPolicy policy() const        { return policy_; }
+
+    // Years are tracked on demand; markUsed() ignores IDs of untracked years
+    bool tracks(int year) const { return years_.count(year) != 0; }
+    void track(int year);
+    void markUsed(uint64_t id);
+    void release(uint64_t id);   // makes the serial available again
+    void clear();
+
+    // One unused ID of `year`, marked as used; false if the year is full or out of range
+    bool   allocate(int year, uint64_t& id);
+    // Up to n IDs appended to out; returns how many were allocated
+    size_t allocate(int year, size_t n, std::vector<uint64_t>& out);
+
+    size_t available(int year) const;
+
+private:
+    static constexpr size_t WORDS = (SERIALS + 63) / 64;
+
+    struct Year {
+        std::vector<uint64_t> used = std::vector<uint64_t>(WORDS, 0);  // bit per serial
+        uint32_t              count{0};      // used serials
+        uint32_t              cursor{0};     // Sequential: every serial below is used
+        bool                  pooled{false}; // Random: pool_ has been built
+        std::vector<uint32_t> pool;          // Random: free serials (may hold stale entries)
+    };
+
+    static bool test(const Year& y, uint32_t s) { return (y.used[s >> 6] >> (s & 63)) & 1u; }
+    static void set(Year& y, uint32_t s);
+
+    bool nextSequential(Year& y, uint32_t& serial);
+    bool nextRandom(Year& y, uint32_t& serial);
+
+    IDPolicy                       policy_{IDPolicy::Random};
+    std::mt19937                   rng_;
+    std::unordered_map<int, Year>  years_;
+};
+
+#endif // STUDENT_ID_ALLOCATOR_HPP
@@ -0,0 +1,139 @@
+#ifndef STUDENT_RECORD_HPP
+#define STUDENT_RECORD_HPP
+
+#include "DepartmentDictionary.hpp"
+#include "Student.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Compact, fixed-width in-memory form of a validated Student (40 bytes, no heap).
+// The name lives in an inline buffer, the department is an ID into the process-wide
+// DepartmentDictionary, the student ID and tel are packed as integers and the
+// admission year is computed once. Build it only from validated fields: over-long
+// text is truncated to the field size.
+struct StudentRecord {
+    static constexpr size_t NAME_MAX = 15;
+    static constexpr size_t DEPT_MAX = 20;
+    static constexpr size_t ID_LEN   = 10;
+    static constexpr size_t TEL_MAX  = 12;
+
+    uint64_t id{};          // 10-digit student ID as a number
+    uint64_t telNum{};      // tel digits as a number (leading zeros restored from telLen)
+    uint16_t birth{};       // birth year
+    uint16_t admission{};   // first 4 digits of the ID
+    uint16_t dept{};        // DepartmentDictionary ID (0 = empty)
+    uint8_t  nameLen{};
+    uint8_t  telLen{};
+    char     nameBuf[NAME_MAX]{};
+
+    // ---------- Accessors ----------
+    std::string_view name()       const { return std::string_view(nameBuf, nameLen); }
+    std::string_view department() const { return DepartmentDictionary::global().name(dept); }
+    int              birthYear()     const { return birth; }
+    int              admissionYear() const { return admission; }
+
+    // Writes the 10 ID digits into out (no terminator)
+    void writeID(char* out) const { writeDigits(id, ID_LEN, out); }
+    // Writes the tel digits into out (no terminator, at most TEL_MAX); returns their count
+    size_t writeTel(char* out) const {
+        size_t n = telLen < TEL_MAX ? telLen : TEL_MAX;
+        writeDigits(telNum, n, out);
+        return n;
+    }
+
+    std::string studentID() const { std::string s(ID_LEN, '0'); writeID(&s[0]); return s; }
+    std::string tel()       const { char buf[TEL_MAX]; return std::string(buf, writeTel(buf)); }
+
+    // Appends one line in the student file layout (name, id, birth year, department, tel)
+    void appendTSV(std::string& out) const {
+        char buf[TEL_MAX];   // holds the ID digits, then the tel digits
+        out.append(nameBuf, nameLen);
+        out += '\t';
+        writeID(buf);
+        out.append(buf, ID_LEN);
+        out += '\t';
+        out += std::to_string(birth);
+        out += '\t';
+        out += department();
+        out += '\t';
+        out.append(buf, writeTel(buf));
+        out += '\n';
+    }
+
+    // Key for tel lookups: distinguishes "0101" from "101"
+    uint64_t telKey() const { return (telNum << 4) | telLen; }
+
+    Student toStudent() const {
+        return Student{ std::string(name()), studentID(), birthYear(), std::string(department()), tel() };
+    }
+
+    // ---------- Mutators (validated input only) ----------
+    void setName(std::string_view s)       { nameLen = static_cast<uint8_t>(copyText(s, nameBuf, NAME_MAX)); }
+    // False (dept unchanged) if the department dictionary has no room for a new name
+    bool setDepartment(std::string_view s) {
+        return DepartmentDictionary::global().intern(s.substr(0, DEPT_MAX), dept);
+    }
+    void setTel(std::string_view s) {
+        uint64_t key = 0;
+        if (!packTel(s, key)) key = 0;
+        telNum = key >> 4;
+        telLen = static_cast<uint8_t>(key & 0xF);
+    }
+
+    // ---------- Packing ----------
+    // False if the department cannot be interned (dictionary full): the row must be rejected
+    static bool make(std::string_view name, std::string_view studentID, int birthYear,
+                     std::string_view department, std::string_view tel, StudentRecord& r) {
+        r = StudentRecord();
+        if (!r.setDepartment(department)) return false;
+        r.setName(name);
+        packID(studentID, r.id);
+        r.admission = static_cast<uint16_t>(r.id / 1000000);
+        r.birth     = static_cast<uint16_t>(birthYear);
+        r.setTel(tel);
+        return true;
+    }
+
+    static bool from(const Student& s, StudentRecord& r) {
+        return make(s.name, s.studentID, s.birthYear, s.department, s.tel, r);
+    }
+
+    // Parses a 10-digit ID; false if the text is not exactly 10 digits
+    static bool packID(std::string_view s, uint64_t& out) {
+        if (s.size() != ID_LEN) return false;
+        return parseDigits(s, out);
+    }
+
+    // Produces the telKey() of a 1..12 digit tel; false for anything else
+    static bool packTel(std::string_view s, uint64_t& key) {
+        uint64_t v = 0;
+        if (s.empty() || s.size() > TEL_MAX || !parseDigits(s, v)) return false;
+        key = (v << 4) | s.size();
+        return true;
+    }
+
+private:
+    static size_t copyText(std::string_view s, char* buf, size_t cap) {
+        size_t n = s.size() < cap ? s.size() : cap;
+        std::memcpy(buf, s.data(), n);
+        return n;
+    }
+
+    static bool parseDigits(std::string_view s, uint64_t& out) {
+        uint64_t v = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') return false;
+            v = v * 10 + static_cast<uint64_t>(c - '0');
+        }
+        out = v;
+        return true;
+    }
+
+    static void writeDigits(uint64_t v, size_t width, char* out) {
+        for (size_t i = width; i-- > 0; ) { out[i] = static_cast<char>('0' + v % 10); v /= 10; }
+    }
+};
+
+#endif // STUDENT_RECORD_HPP
@@ -0,0 +1,411 @@
+#include "StudentServer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // no SIGPIPE suppression flag on this platform
+#endif
+
+// Bytes read from a socket per call
+static const size_t RECV_BLOCK = 1 << 16;
+// Longest request line; a peer that sends more without '\n' is disconnected
+static const size_t MAX_LINE = 1 << 16;
+
+// Splits on spaces and tabs (empty words dropped)
+static std::vector<std::string> splitWords(std::string_view s) {
+    std::vector<std::string> words;
+    size_t i = 0;
+    while (i < s.size()) {
+        while (i < s.size() && (s[i] == ' ' || s[i] == '\t')) ++i;
+        size_t j = i;
+        while (j < s.size() && s[j] != ' ' && s[j] != '\t') ++j;
+        if (j > i) words.emplace_back(s.substr(i, j - i));
+        i = j;
+    }
+    return words;
+}
+
+static bool isWriteCommand(std::string_view cmd) {
+    return cmd == "INS" || cmd == "NAME" || cmd == "DEPT" || cmd == "TEL" || cmd == "DEL";
+}
+
+static std::string_view commandOf(std::string_view line) {
+    return line.substr(0, line.find_first_of(" \t"));
+}
+
+static void appendResult(std::string& out, const ResultView& res) {
+    out += "OK " + std::to_string(res.size()) + "\n";
+    for (const auto& r : res) r.appendTSV(out);
+}
+
+// ---------- REQUESTS ----------
+bool StudentServer::handle(std::string_view requests, ConcurrentStudentDB::Reader& reader, std::string& out) {
+    std::vector<std::string_view> writes; // consecutive write requests, applied together
+    bool open = true;
+
+    size_t pos = 0;
+    while (pos < requests.size() && open) {
+        size_t nl = requests.find('\n', pos);
+        if (nl == std::string_view::npos) nl = requests.size();
+        std::string_view line = requests.substr(pos, nl - pos);
+        pos = nl + 1;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        // Blank lines are requests too (answered with an error), so replies stay in step
+
+        std::string_view cmd = commandOf(line);
+        if (isWriteCommand(cmd)) {
+            writes.push_back(line);
+            continue;
+        }
+        if (!writes.empty()) {
+            applyWrites(writes, out);
+            writes.clear();
+        }
+        if (cmd == "QUIT") {
+            open = false;
+        } else if (cmd == "SHUTDOWN") {
+            out += "OK 0\n";
+            stop();
+            open = false;
+        } else {
+            answerRead(line, reader, out);
+        }
+    }
+    if (!writes.empty()) applyWrites(writes, out);
+    return open;
+}
+
+// All the writes go into one new version (one copy of the database, one save)
+void StudentServer::applyWrites(const std::vector<std::string_view>& lines, std::string& out) {
+    std::vector<std::string> replies(lines.size());
+    bool changed = false;
+    bool saved = db_.write([&](StudentDB& db) {
+        for (size_t i = 0; i < lines.size(); ++i) {
+            std::string_view line = lines[i];
+            size_t tab = line.find('\t');
+            std::string_view cmd  = line.substr(0, tab);
+            std::string_view rest = (tab == std::string_view::npos) ? std::string_view() : line.substr(tab + 1);
+            std::string& reply = replies[i];
+
+            if (cmd == "INS") {
+                StudentFields f;
+                if (!FileStudentRepository::parseLine(rest, f)) { reply = "ERR Format\n"; continue; }
+                std::vector<std::string> err;
+                Student s{ std::string(f.name), std::string(f.studentID), f.birthYear,
+                           std::string(f.department), std::string(f.tel) };
+                if (db.insert(s, err)) { reply = "OK 0\n"; changed = true; continue; }
+                reply = "ERR ";
+                for (size_t k = 0; k < err.size(); ++k) reply += (k ? ", " : "") + err[k];
+                reply += '\n';
+                continue;
+            }
+
+            if (cmd == "DEL") {
+                std::string err;
+                if (db.remove(std::string(rest), err)) { reply = "OK 0\n"; changed = true; continue; }
+                reply = "ERR " + err + "\n";
+                continue;
+            }
+
+            size_t sep = rest.find('\t');
+            if (sep == std::string_view::npos) { reply = "ERR Format\n"; continue; }
+            std::string id(rest.substr(0, sep));
+            std::string value(rest.substr(sep + 1));
+            std::string err;
+            bool ok = (cmd == "NAME") ? db.updateName(id, value, err)
+                    : (cmd == "DEPT") ? db.updateDepartment(id, value, err)
+                    :                   db.updateTel(id, value, err);
+            if (ok) { reply = "OK 0\n"; changed = true; continue; }
+            if (err.find("already exists") != std::string::npos) err = "DUP_TEL";
+            reply = "ERR " + err + "\n";
+        }
+        return changed;
+    });
+    // The version was dropped: none of the accepted writes took effect
+    if (changed && !saved) {
+        for (auto& r : replies) if (r == "OK 0\n") r = "ERR SAVE\n";
+    }
+    for (const auto& r : replies) out += r;
+}
+
+void StudentServer::answerRead(std::string_view line, ConcurrentStudentDB::Reader& reader, std::string& out) {
+    std::vector<std::string> words = splitWords(line);
+    if (words.empty()) { out += "ERR empty request\n"; return; } // blank, or only spaces/tabs
+    const std::string& cmd = words[0];
+    const StudentDB& db = reader.get();
+
+    if (cmd == "PING") {
+        out += "OK 0\n";
+    } else if (cmd == "QUERY") {
+        Query q = Query::all();
+        std::string err;
+        if (words.size() < 2 || !Query::parse(std::vector<std::string>(words.begin() + 1, words.end()), q, err)) {
+            out += "ERR " + (err.empty() ? std::string("empty condition") : err) + "\n";
+            return;
+        }
+        appendResult(out, db.find(q));
+    } else if (cmd == "GET" && words.size() == 2) {
+        appendResult(out, db.searchByID(words[1]));
+    } else if (cmd == "STATS") {
+        std::vector<StatKey> order;
+        for (size_t i = 1; i < words.size(); ++i) {
+            if      (words[i] == "1") order.push_back(StatKey::AdmissionYear);
+            else if (words[i] == "2") order.push_back(StatKey::BirthYear);
+            else if (words[i] == "3") order.push_back(StatKey::Department);
+            else { out += "ERR invalid key: " + words[i] + "\n"; return; }
+        }
+        std::ostringstream text;
+        db.groupSummary(order, text);
+        std::string body = text.str();
+        if (body.size() >= 2 && body.compare(body.size() - 2, 2, "\n\n") == 0) body.pop_back(); // trailing blank line
+        out += "OK " + std::to_string(std::count(body.begin(), body.end(), '\n')) + "\n";
+        out += body;
+    } else if (cmd == "METRICS") {
+        std::ostringstream json;
+        Metrics::global().dumpJSON(json);
+        out += "OK 1\n" + json.str();
+    } else {
+        out += "ERR unknown request: " + cmd + "\n";
+    }
+}
+
+#ifndef _WIN32
+// ---------- SOCKETS ----------
+static bool sendAll(int fd, const char* p, size_t n) {
+    while (n > 0) {
+        ssize_t k = ::send(fd, p, n, MSG_NOSIGNAL);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false;
+        p += k;
+        n -= static_cast<size_t>(k);
+    }
+    return true;
+}
+
+static ssize_t recvSome(int fd, char* buf, size_t n) {
+    ssize_t k;
+    do { k = ::recv(fd, buf, n, 0); } while (k < 0 && errno == EINTR);
+    return k;
+}
+
+static bool makeAddress(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Error: invalid socket path " << path << "\n";
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+StudentServer::~StudentServer() {
+    stop();
+    if (listenFd_ >= 0) ::close(listenFd_);
+    if (!socketPath_.empty()) ::unlink(socketPath_.c_str());
+}
+
+bool StudentServer::listen(const std::string& socketPath) {
+    sockaddr_un addr;
+    if (!makeAddress(socketPath, addr)) return false;
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0) { std::perror("socket"); return false; }
+    ::unlink(socketPath.c_str());
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listenFd_, 64) < 0) {
+        std::cerr << "Error: cannot listen on " << socketPath << ": " << std::strerror(errno) << "\n";
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    socketPath_ = socketPath;
+    return true;
+}
+
+void StudentServer::run() {
+    while (!stopping_) {
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break; // stop() shut the listening socket down
+        }
+        std::lock_guard<std::mutex> lock(connMutex_);
+        if (stopping_) { ::close(fd); break; }
+        connFds_.push_back(fd);
+        ++active_;
+        std::thread([this, fd] { serveConnection(fd); }).detach();
+    }
+    std::unique_lock<std::mutex> lock(connMutex_);
+    idle_.wait(lock, [this] { return active_ == 0; });
+}
+
+// Wakes every blocked accept()/recv(); run() returns once the connections are done
+void StudentServer::stop() {
+    std::lock_guard<std::mutex> lock(connMutex_);
+    if (stopping_.exchange(true)) return;
+    if (listenFd_ >= 0) ::shutdown(listenFd_, SHUT_RDWR);
+    for (int fd : connFds_) ::shutdown(fd, SHUT_RD);
+}
+
+void StudentServer::serveConnection(int fd) {
+    ConcurrentStudentDB::Reader reader(db_);
+    std::string in, out;
+    std::vector<char> buf(RECV_BLOCK);
+    bool open = true;
+
+    while (open) {
+        ssize_t n = recvSome(fd, buf.data(), buf.size());
+        if (n <= 0) {
+            if (!in.empty()) handle(in, reader, out); // last request without '\n'
+            in.clear();
+            break;
+        }
+        in.append(buf.data(), static_cast<size_t>(n));
+        size_t last = in.rfind('\n');
+        if (last != std::string::npos) {
+            // Everything received so far, answered with one write
+            open = handle(std::string_view(in).substr(0, last + 1), reader, out);
+            in.erase(0, last + 1);
+            if (!sendAll(fd, out.data(), out.size())) break;
+            out.clear();
+        }
+        if (in.size() > MAX_LINE) { // unfinished line past the limit: never buffered further
+            out += "ERR line too long\n";
+            in.clear();
+            break;
+        }
+    }
+    if (!out.empty()) sendAll(fd, out.data(), out.size());
+    ::close(fd);
+
+    std::lock_guard<std::mutex> lock(connMutex_);
+    connFds_.erase(std::find(connFds_.begin(), connFds_.end(), fd));
+    if (--active_ == 0) idle_.notify_all();
+}
+
+// ---------- CLIENT ----------
+int StudentClient::connectTo(const std::string& socketPath) {
+    sockaddr_un addr;
+    if (!makeAddress(socketPath, addr)) return -1;
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) { std::perror("socket"); return -1; }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Error: cannot connect to " << socketPath << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int StudentClient::run(const std::string& socketPath) {
+    int fd = connectTo(socketPath);
+    if (fd < 0) return 1;
+
+    // Requests go out on their own thread so a large pipeline never waits on unread responses
+    std::thread sender([fd] {
+        std::vector<char> buf(RECV_BLOCK);
+        size_t n;
+        while ((n = std::fread(buf.data(), 1, buf.size(), stdin)) > 0) {
+            if (!sendAll(fd, buf.data(), n)) break;
+        }
+        ::shutdown(fd, SHUT_WR); // end of requests: the server answers the rest and closes
+    });
+
+    std::vector<char> buf(RECV_BLOCK);
+    ssize_t n;
+    while ((n = recvSome(fd, buf.data(), buf.size())) > 0) {
+        std::fwrite(buf.data(), 1, static_cast<size_t>(n), stdout);
+    }
+    std::fflush(stdout);
+    sender.join();
+    ::close(fd);
+    return 0;
+}
+
+int StudentClient::load(const std::string& socketPath, const std::string& request,
+                        size_t requests, size_t connections, size_t pipeline) {
+    std::atomic<size_t> claimed{0}, answered{0}, errors{0};
+    std::atomic<bool>   failed{false};
+
+    auto worker = [&] {
+        int fd = connectTo(socketPath);
+        if (fd < 0) { failed = true; return; }
+        std::string batch, line;
+        std::vector<char> buf(RECV_BLOCK);
+        size_t skip = 0; // data lines left in the current response
+
+        while (!failed) {
+            size_t first = claimed.fetch_add(pipeline);
+            if (first >= requests) break;
+            size_t k = std::min(pipeline, requests - first);
+
+            batch.clear();
+            for (size_t i = 0; i < k; ++i) { batch += request; batch += '\n'; }
+            if (!sendAll(fd, batch.data(), batch.size())) { failed = true; break; }
+
+            // Read until all k responses (header + data lines) are in
+            size_t done = 0;
+            while (done < k || skip > 0) {
+                ssize_t n = recvSome(fd, buf.data(), buf.size());
+                if (n <= 0) { failed = true; break; }
+                for (ssize_t i = 0; i < n; ++i) {
+                    char c = buf[static_cast<size_t>(i)];
+                    if (c != '\n') { if (skip == 0) line += c; continue; }
+                    if (skip > 0) { --skip; continue; }
+                    if (line.compare(0, 3, "OK ") == 0) skip = std::strtoul(line.c_str() + 3, nullptr, 10);
+                    else ++errors;
+                    ++done;
+                    line.clear();
+                }
+            }
+            answered += done;
+        }
+        ::close(fd);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (size_t c = 0; c < connections; ++c) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "requests " << answered << ", errors " << errors
+              << ", connections " << connections << ", pipeline " << pipeline
+              << ", seconds " << secs
+              << ", requests/s " << static_cast<uint64_t>(answered / (secs > 0 ? secs : 1)) << "\n";
+    return failed ? 1 : 0;
+}
+
+#else
+// ---------- UNSUPPORTED PLATFORM ----------
+StudentServer::~StudentServer() {}
+bool StudentServer::listen(const std::string&) {
+    std::cerr << "Error: the server needs Unix domain sockets\n";
+    return false;
+}
+void StudentServer::run() {}
+void StudentServer::stop() {}
+void StudentServer::serveConnection(int) {}
+
+int StudentClient::connectTo(const std::string&) { return -1; }
+int StudentClient::run(const std::string&) {
+    std::cerr << "Error: the client needs Unix domain sockets\n";
+    return 1;
+}
+int StudentClient::load(const std::string&, const std::string&, size_t, size_t, size_t) {
+    std::cerr << "Error: the client needs Unix domain sockets\n";
+    return 1;
+}
+#endif
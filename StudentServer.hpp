@@ -0,0 +1,84 @@
+#ifndef STUDENT_SERVER_HPP
+#define STUDENT_SERVER_HPP
+
+#include "ConcurrentStudentDB.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Long-running request server over a Unix domain socket (POSIX only).
+// The database stays in memory; one thread per connection, reads run on
+// snapshots and never wait for writers (see ConcurrentStudentDB).
+//
+// Protocol: one request per line, answered in order. Clients may pipeline any
+// number of requests; the server answers everything it has received in one write.
+//   PING                              -> OK 0
+//   QUERY <field=value> ...           -> OK n, then n student lines (Query::parse syntax)
+//   GET <id>                          -> OK 0 or OK 1, then the student line
+//   STATS [1] [2] [3]                 -> OK n, then n lines of the group summary
+//   METRICS                           -> OK 1, then Metrics::dumpJSON() on one line
+//   INS\t<name>\t<id>\t<birth>\t<dept>\t<tel>   (journal line format, tab-separated)
+//   NAME\t<id>\t<value>  DEPT\t<id>\t<value>  TEL\t<id>\t<value>  DEL\t<id>
+//                                     -> OK 0, or ERR <keys> (same keys as insert/update)
+//   QUIT                              -> closes the connection
+//   SHUTDOWN                          -> OK 0, then checkpoints and stops the server
+// Errors: ERR <message> (one line). Student lines use the student file layout.
+// A blank request gets ERR empty request; a line longer than 64 KiB gets
+// ERR line too long and the connection is closed.
+// Consecutive write requests in one batch are applied as one new version; if
+// saving it fails, every write of the batch that was accepted gets ERR SAVE.
+class StudentServer {
+public:
+    explicit StudentServer(ConcurrentStudentDB& db) : db_(db) {}
+    ~StudentServer();
+
+    StudentServer(const StudentServer&) = delete;
+    StudentServer& operator=(const StudentServer&) = delete;
+
+    // Binds and listens (an existing socket file at the path is replaced)
+    bool listen(const std::string& socketPath);
+    // Accepts connections until SHUTDOWN or stop(); returns after all connections end
+    void run();
+    void stop();
+
+    // Answers every request in `requests` (complete lines) into `out`; false after
+    // QUIT or SHUTDOWN. Public so the protocol can be exercised without a socket.
+    bool handle(std::string_view requests, ConcurrentStudentDB::Reader& reader, std::string& out);
+
+private:
+    void serveConnection(int fd);
+    void applyWrites(const std::vector<std::string_view>& lines, std::string& out);
+    void answerRead(std::string_view line, ConcurrentStudentDB::Reader& reader, std::string& out);
+
+    ConcurrentStudentDB& db_;
+    std::string          socketPath_;
+    int                  listenFd_{-1};
+    std::atomic<bool>    stopping_{false};
+
+    std::mutex              connMutex_;   // guards connFds_ and active_
+    std::condition_variable idle_;        // signalled when the last connection ends
+    std::vector<int>        connFds_;     // open connections, woken up by stop()
+    size_t                  active_{0};
+};
+
+// Client side of the protocol
+class StudentClient {
+public:
+    // Sends request lines from stdin (pipelined) and copies every response to stdout.
+    // Returns the process exit code.
+    static int run(const std::string& socketPath);
+
+    // Load generator: `connections` threads each keep `pipeline` requests in flight
+    // until `requests` have been answered in total; prints requests per second.
+    static int load(const std::string& socketPath, const std::string& request,
+                    size_t requests, size_t connections, size_t pipeline);
+
+private:
+    static int connectTo(const std::string& socketPath);
+};
+
+#endif // STUDENT_SERVER_HPP
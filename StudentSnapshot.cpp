@@ -0,0 +1,186 @@
+#include "StudentSnapshot.hpp"
+#include "MappedFile.hpp"
+#include "StudentValidator.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct Header {
+    char     magic[8];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t recordSize;
+    uint64_t recordCount;
+    uint32_t deptCount;
+    uint32_t reserved;
+};
+static_assert(sizeof(Header) == 32, "snapshot header layout");
+
+struct Row {
+    uint64_t id;
+    uint64_t telNum;
+    uint16_t birth;
+    uint16_t dept;      // index into the department table
+    uint8_t  nameLen;
+    uint8_t  telLen;
+    char     name[StudentRecord::NAME_MAX];
+    char     pad[3];
+};
+static_assert(sizeof(Row) == 40, "snapshot row layout");
+
+constexpr uint64_t MAX_ID = 9999999999ull;   // 10 digits
+constexpr uint64_t POW10[StudentRecord::TEL_MAX + 1] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+};
+
+} // namespace
+
+constexpr char StudentSnapshot::MAGIC[8];
+
+bool StudentSnapshot::isSnapshot(const std::string& path) {
+    std::ifstream fin(path, std::ios::binary);
+    char magic[sizeof(MAGIC)] = {};
+    if (!fin.read(magic, sizeof(magic))) return false;
+    return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool StudentSnapshot::read(const std::string& path, std::vector<StudentRecord>& out, bool& validated) {
+    MappedFile map;
+    if (!map.open(path) || map.size() < sizeof(Header)) return false;
+
+    Header h;
+    std::memcpy(&h, map.data(), sizeof(h));
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (h.version > VERSION || h.recordSize != sizeof(Row)) {
+        std::cerr << "Error: unsupported snapshot version in " << path << "\n";
+        return false;
+    }
+
+    const char* p   = map.data() + sizeof(Header);
+    const char* end = map.data() + map.size();
+    auto corrupt = [&path]() {
+        std::cerr << "Error: corrupt snapshot " << path << "\n";
+        return false;
+    };
+
+    // Department string table (valid department names), checked in full before
+    // anything is interned
+    std::vector<std::string_view> names;
+    for (uint32_t i = 0; i < h.deptCount; ++i) {
+        if (p >= end) return corrupt();
+        size_t len = static_cast<unsigned char>(*p++);
+        if (len > StudentRecord::DEPT_MAX || static_cast<size_t>(end - p) < len) return corrupt();
+        if (!StudentValidator::validDepartment(std::string_view(p, len))) return corrupt();
+        names.emplace_back(p, len);
+        p += len;
+    }
+
+    if (static_cast<uint64_t>(end - p) / sizeof(Row) < h.recordCount) return corrupt(); // truncated
+
+    // The same rules as StudentValidator::validRecord on the packed fields (ID/tel digit
+    // widths, admission year, name characters, department table), all O(1) per row. A
+    // row that breaks them means the file is damaged or forged, so FLAG_VALIDATED is
+    // only trusted once every row passed.
+    for (uint64_t i = 0; i < h.recordCount; ++i) {
+        Row row;
+        std::memcpy(&row, p + i * sizeof(Row), sizeof(row));
+        if (row.id > MAX_ID || !StudentValidator::validAdmissionYear(static_cast<int>(row.id / 1000000))
+            || row.nameLen > StudentRecord::NAME_MAX
+            || !StudentValidator::validName(std::string_view(row.name, row.nameLen))
+            || row.telLen < 1 || row.telLen > StudentRecord::TEL_MAX || row.telNum >= POW10[row.telLen]
+            || !StudentValidator::validBirthYear(row.birth) || row.dept >= names.size()) {
+            return corrupt();
+        }
+    }
+
+    // Interned once; rows then carry dictionary IDs
+    std::vector<uint16_t> depts;
+    depts.reserve(names.size());
+    for (auto name : names) {
+        uint16_t id = 0;
+        if (!DepartmentDictionary::global().intern(name, id)) return false; // dictionary full
+        depts.push_back(id);
+    }
+
+    out.clear();
+    out.reserve(static_cast<size_t>(h.recordCount));
+    for (uint64_t i = 0; i < h.recordCount; ++i, p += sizeof(Row)) {
+        Row row;
+        std::memcpy(&row, p, sizeof(row));
+
+        StudentRecord r;
+        r.id        = row.id;
+        r.telNum    = row.telNum;
+        r.telLen    = row.telLen;
+        r.birth     = row.birth;
+        r.admission = static_cast<uint16_t>(row.id / 1000000);
+        r.setName(std::string_view(row.name, row.nameLen));
+        r.dept      = depts[row.dept];
+        out.push_back(r);
+    }
+    validated = (h.flags & FLAG_VALIDATED) != 0;
+    return true;
+}
+
+bool StudentSnapshot::write(const std::string& path, const std::vector<StudentRecord>& in, bool validated) {
+    // Department table in order of first appearance (dictionary ID -> table index + 1)
+    std::vector<uint32_t> tableOf(DepartmentDictionary::global().size());
+    std::vector<std::string_view> depts;
+    std::vector<uint16_t> rowDept;
+    rowDept.reserve(in.size());
+    for (const auto& r : in) {
+        if (r.dept >= tableOf.size()) tableOf.resize(r.dept + size_t{1});
+        uint32_t& slot = tableOf[r.dept];
+        if (slot == 0) {
+            depts.push_back(r.department());
+            slot = static_cast<uint32_t>(depts.size());
+        }
+        rowDept.push_back(static_cast<uint16_t>(slot - 1));
+    }
+
+    Header h{};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version     = VERSION;
+    h.flags       = validated ? FLAG_VALIDATED : 0;
+    h.recordSize  = sizeof(Row);
+    h.recordCount = in.size();
+    h.deptCount   = static_cast<uint32_t>(depts.size());
+
+    std::string buf;
+    buf.reserve(sizeof(Header) + depts.size() * (StudentRecord::DEPT_MAX + 1) + in.size() * sizeof(Row));
+    buf.append(reinterpret_cast<const char*>(&h), sizeof(h));
+    for (auto d : depts) {
+        buf += static_cast<char>(d.size());
+        buf.append(d.data(), d.size());
+    }
+    for (size_t i = 0; i < in.size(); ++i) {
+        const StudentRecord& r = in[i];
+        Row row{};
+        row.id      = r.id;
+        row.telNum  = r.telNum;
+        row.birth   = r.birth;
+        row.dept    = rowDept[i];
+        row.nameLen = r.nameLen;
+        row.telLen  = r.telLen;
+        std::memcpy(row.name, r.nameBuf, r.nameLen);
+        buf.append(reinterpret_cast<const char*>(&row), sizeof(row));
+    }
+
+    std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+    if (!fout.is_open()) {
+        std::cerr << "Error: cannot write file " << path << "\n";
+        return false;
+    }
+    fout.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    fout.close();
+    if (fout.fail()) {
+        std::cerr << "Error: cannot write file " << path << "\n";
+        return false;
+    }
+    return true;
+}
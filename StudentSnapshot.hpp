@@ -0,0 +1,32 @@
+#ifndef STUDENT_SNAPSHOT_HPP
+#define STUDENT_SNAPSHOT_HPP
+
+#include "StudentRecord.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Versioned binary snapshot of the student table (little-endian hosts).
+//
+//   Header   magic "SDBSNAP\0", version, flags, record size, record count, department count
+//   Strings  department table: [u8 length][bytes] per entry
+//   Records  fixed-size rows; the department is an index into the table
+//
+// FLAG_VALIDATED marks a snapshot written from already validated, duplicate-free
+// data, so loading can skip StudentValidator entirely.
+class StudentSnapshot {
+public:
+    static constexpr char     MAGIC[8]       = { 'S','D','B','S','N','A','P','\0' };
+    static constexpr uint16_t VERSION        = 1;
+    static constexpr uint16_t FLAG_VALIDATED = 0x1;
+
+    // True if the file starts with the snapshot magic
+    static bool isSnapshot(const std::string& path);
+
+    // Reads every row into out; false if the file is missing, truncated or of an unknown version
+    static bool read(const std::string& path, std::vector<StudentRecord>& out, bool& validated);
+
+    static bool write(const std::string& path, const std::vector<StudentRecord>& in, bool validated);
+};
+
+#endif // STUDENT_SNAPSHOT_HPP
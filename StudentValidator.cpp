@@ -1,33 +1,148 @@
 #include "StudentValidator.hpp"
-#include <cctype>
+#include <cstring>
 
-bool StudentValidator::isDigits(const std::string& s) {
-    if (s.empty()) return false;
-    for (unsigned char c : s) {
-        if (!std::isdigit(c)) return false;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STUDENT_VALIDATOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(STUDENT_VALIDATOR_SSE2) && defined(__GNUC__)
+#define STUDENT_VALIDATOR_AVX2 1 // compiled with a target attribute, selected at run time
+#include <immintrin.h>
+#endif
+
+namespace {
+
+enum class CharClass { Digit, AlphaSpace };
+
+// ---------- Scalar ----------
+inline bool isDigitChar(unsigned char c) {
+    return static_cast<unsigned>(c - '0') < 10u;
+}
+
+// Letters, ' ' and '\t' '\n' '\v' '\f' '\r' (std::isalpha || std::isspace in the "C" locale)
+inline bool isAlphaSpaceChar(unsigned char c) {
+    unsigned char lower = static_cast<unsigned char>(c | 0x20);
+    return static_cast<unsigned>(lower - 'a') < 26u || c == ' ' || static_cast<unsigned>(c - '\t') < 5u;
+}
+
+#ifndef STUDENT_VALIDATOR_SSE2
+bool scalarCheck(const char* p, size_t n, CharClass cls) {
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char c = static_cast<unsigned char>(p[i]);
+        if (!(cls == CharClass::Digit ? isDigitChar(c) : isAlphaSpaceChar(c))) return false;
     }
     return true;
 }
+#endif
 
-bool StudentValidator::isAlphaSpace(const std::string& s) {
-    if (s.empty()) return false;
-    for (unsigned char c : s) {
-        if (!(std::isalpha(c) || std::isspace(c))) return false;
+#ifdef STUDENT_VALIDATOR_SSE2
+// ---------- SSE2: 16 bytes per step ----------
+// Signed byte compares: bytes >= 0x80 are negative and fail every range test.
+inline __m128i classify16(__m128i x, CharClass cls) {
+    if (cls == CharClass::Digit) {
+        return _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)),
+                             _mm_cmplt_epi8(x, _mm_set1_epi8('9' + 1)));
     }
-    return true;
+    __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+    __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                  _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+                                 _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('\t' - 1)),
+                                               _mm_cmplt_epi8(x, _mm_set1_epi8('\r' + 1))));
+    return _mm_or_si128(alpha, space);
+}
+
+bool sse2Check(const char* p, size_t n, CharClass cls) {
+    for (; n >= 16; p += 16, n -= 16) {
+        __m128i ok = classify16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), cls);
+        if (_mm_movemask_epi8(ok) != 0xFFFF) return false;
+    }
+    if (n == 0) return true;
+    // Tail: copy into a block so nothing past the field is read; only n lanes count
+    alignas(16) char block[16] = {};
+    std::memcpy(block, p, n);
+    __m128i ok = classify16(_mm_load_si128(reinterpret_cast<const __m128i*>(block)), cls);
+    unsigned lanes = (1u << n) - 1u;
+    return (static_cast<unsigned>(_mm_movemask_epi8(ok)) & lanes) == lanes;
+}
+#endif
+
+#ifdef STUDENT_VALIDATOR_AVX2
+// ---------- AVX2: 32 bytes per step ----------
+__attribute__((target("avx2")))
+inline __m256i classify32(__m256i x, CharClass cls) {
+    if (cls == CharClass::Digit) {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('0' - 1)),
+                                _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), x));
+    }
+    __m256i lower = _mm256_or_si256(x, _mm256_set1_epi8(0x20));
+    __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+    __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                                    _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('\t' - 1)),
+                                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), x)));
+    return _mm256_or_si256(alpha, space);
+}
+
+__attribute__((target("avx2")))
+bool avx2Check(const char* p, size_t n, CharClass cls) {
+    for (; n >= 32; p += 32, n -= 32) {
+        __m256i ok = classify32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), cls);
+        if (static_cast<unsigned>(_mm256_movemask_epi8(ok)) != 0xFFFFFFFFu) return false;
+    }
+    if (n == 0) return true;
+    alignas(32) char block[32] = {};
+    std::memcpy(block, p, n);
+    __m256i ok = classify32(_mm256_load_si256(reinterpret_cast<const __m256i*>(block)), cls);
+    unsigned lanes = (n == 32) ? 0xFFFFFFFFu : ((1u << n) - 1u);
+    return (static_cast<unsigned>(_mm256_movemask_epi8(ok)) & lanes) == lanes;
+}
+#endif
+
+using CheckFn = bool (*)(const char*, size_t, CharClass);
+
+// Best kernel for this CPU, chosen once
+CheckFn selectKernel() {
+#ifdef STUDENT_VALIDATOR_AVX2
+    if (__builtin_cpu_supports("avx2")) return avx2Check;
+#endif
+#ifdef STUDENT_VALIDATOR_SSE2
+    return sse2Check;
+#else
+    return scalarCheck;
+#endif
 }
 
-bool StudentValidator::validName(const std::string& s) {
+const CheckFn checkChars = selectKernel();
+
+} // namespace
+
+bool StudentValidator::isDigits(std::string_view s) {
+    if (s.empty()) return false;
+    return checkChars(s.data(), s.size(), CharClass::Digit);
+}
+
+bool StudentValidator::isAlphaSpace(std::string_view s) {
+    if (s.empty()) return false;
+    return checkChars(s.data(), s.size(), CharClass::AlphaSpace);
+}
+
+bool StudentValidator::validName(std::string_view s) {
     return !s.empty() && s.size() <= 15 && isAlphaSpace(s);
 }
 
-bool StudentValidator::validStudentID(const std::string& s) {
+bool StudentValidator::validStudentID(std::string_view s) {
     if (s.size() != 10 || !isDigits(s)) return false;
-    int year = std::stoi(s.substr(0,4));
-    return (year >= 1900 && year <= 2100);
+    int year = (s[0] - '0') * 1000 + (s[1] - '0') * 100 + (s[2] - '0') * 10 + (s[3] - '0');
+    return validAdmissionYear(year);
 }
 
-bool StudentValidator::validDepartment(const std::string& s) {
+bool StudentValidator::validAdmissionYear(int y) {
+    return (y >= 1900 && y <= 2100);
+}
+
+bool StudentValidator::validDepartment(std::string_view s) {
     return s.size() <= 20 && isAlphaSpace(s);
 }
 
@@ -35,9 +150,43 @@ bool StudentValidator::validBirthYear(int y) {
     return (y >= 1900 && y <= 2100);
 }
 
-bool StudentValidator::validTel(const std::string& s) {
+bool StudentValidator::validTel(std::string_view s) {
     // string size is limited to 12 when digits
     if (s.empty()) return false;
     if (s.size() > 12) return false;
     return isDigits(s);
 }
+
+// ---------- RECORD / BATCH ----------
+bool StudentValidator::validRecord(const StudentFields& f) {
+    // Length rules first: they are cheap and bound the buffers below
+    if (f.name.empty() || f.name.size() > 15)             return false;
+    if (f.studentID.size() != 10)                          return false;
+    if (f.department.empty() || f.department.size() > 20) return false;
+    if (f.tel.empty() || f.tel.size() > 12)                return false;
+    if (!validBirthYear(f.birthYear))                      return false;
+
+    // ID + tel: at most 22 digits, one pass
+    char digits[32];
+    std::memcpy(digits, f.studentID.data(), 10);
+    std::memcpy(digits + 10, f.tel.data(), f.tel.size());
+    if (!checkChars(digits, 10 + f.tel.size(), CharClass::Digit)) return false;
+
+    // Name + department: at most 35 letters/spaces, one pass
+    char text[40];
+    std::memcpy(text, f.name.data(), f.name.size());
+    std::memcpy(text + f.name.size(), f.department.data(), f.department.size());
+    if (!checkChars(text, f.name.size() + f.department.size(), CharClass::AlphaSpace)) return false;
+
+    int year = (digits[0] - '0') * 1000 + (digits[1] - '0') * 100 + (digits[2] - '0') * 10 + (digits[3] - '0');
+    return validAdmissionYear(year);
+}
+
+size_t StudentValidator::validateBatch(const StudentFields* rows, size_t n, uint8_t* ok) {
+    size_t valid = 0;
+    for (size_t i = 0; i < n; ++i) {
+        ok[i] = validRecord(rows[i]) ? 1 : 0;
+        valid += ok[i];
+    }
+    return valid;
+}
@@ -1,28 +1,43 @@
 #ifndef STUDENT_VALIDATOR_HPP
 #define STUDENT_VALIDATOR_HPP
 
-#include <string>
+#include "Student.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 class StudentValidator {
 public:
     // Name validation: not empty, length <= 15, letters and spaces only
-    static bool validName(const std::string& s);
+    static bool validName(std::string_view s);
 
     // Student ID validation: exactly 10 digits, first 4 digits between 1900 and 2100
-    static bool validStudentID(const std::string& s);
+    static bool validStudentID(std::string_view s);
+
+    // Admission year (first 4 digits of a student ID): between 1900 and 2100
+    static bool validAdmissionYear(int y);
 
     // Department validation: length <= 20, letters and spaces only
-    static bool validDepartment(const std::string& s);
+    static bool validDepartment(std::string_view s);
 
     // Birth year validation: must be between 1900 and 2100
     static bool validBirthYear(int y);
 
     // Telephone validation: may be empty, digits only, length <= 12
-    static bool validTel(const std::string& s);
+    static bool validTel(std::string_view s);
+
+    // All five checks at once; the digit fields and the text fields are each
+    // checked with one vector pass
+    static bool validRecord(const StudentFields& f);
+
+    // validRecord() for n rows: ok[i] = 1 if rows[i] is valid. Returns the valid count.
+    static size_t validateBatch(const StudentFields* rows, size_t n, uint8_t* ok);
 
 private:
-    static bool isDigits(const std::string& s);
-    static bool isAlphaSpace(const std::string& s);
+    // Character class kernels (AVX2 / SSE2 when available, scalar otherwise).
+    // ASCII only, matching <cctype> in the default "C" locale.
+    static bool isDigits(std::string_view s);
+    static bool isAlphaSpace(std::string_view s);
 };
 
 #endif // STUDENT_VALIDATOR_HPP
@@ -0,0 +1,92 @@
+#include "TableWriter.hpp"
+#include <charconv>
+
+static const std::string BLANKS(32, ' ');
+
+bool TableWriter::parseFormat(const std::string& word, TableFormat& f) {
+    if      (word == "table") f = TableFormat::Table;
+    else if (word == "tsv")   f = TableFormat::TSV;
+    else if (word == "csv")   f = TableFormat::CSV;
+    else return false;
+    return true;
+}
+
+// Left-aligned, padded to width (longer text is not cut), then the column separator
+void TableWriter::cell(std::string_view s, size_t width, bool last) {
+    std::string& buf = out_.buffer();
+    buf.append(s.data(), s.size());
+    if (s.size() < width) buf.append(BLANKS, 0, width - s.size());
+    buf += last ? "\n" : " | ";
+}
+
+void TableWriter::csvField(std::string_view s) {
+    std::string& buf = out_.buffer();
+    if (s.find_first_of(",\"\r\n") == std::string_view::npos) {
+        buf.append(s.data(), s.size());
+        return;
+    }
+    buf += '"';
+    for (char c : s) {
+        if (c == '"') buf += '"';
+        buf += c;
+    }
+    buf += '"';
+}
+
+void TableWriter::header() {
+    if (format_ == TableFormat::Table) {
+        static const std::string separator = std::string(W_NAME + 1, '-') + "+-"
+                                           + std::string(W_ID + 1, '-') + "+-"
+                                           + std::string(W_DEPT + 1, '-') + "+-"
+                                           + std::string(W_B_YEAR + 1, '-') + "+-"
+                                           + std::string(W_TEL + 1, '-') + "\n";
+        cell("Name", W_NAME);
+        cell("Student ID", W_ID);
+        cell("Dept", W_DEPT);
+        cell("Birth Year", W_B_YEAR);
+        cell("Tel", W_TEL, true);
+        out_.buffer() += separator;
+    } else if (format_ == TableFormat::CSV) {
+        out_.buffer() += "name,studentID,birthYear,department,tel\n";
+    }
+}
+
+void TableWriter::row(const StudentRecord& r) {
+    char id[StudentRecord::ID_LEN];
+    char tel[StudentRecord::TEL_MAX];
+    char birth[12];
+    std::string& buf = out_.buffer();
+
+    switch (format_) {
+        case TableFormat::TSV:
+            r.appendTSV(buf);
+            break;
+        case TableFormat::Table: {
+            r.writeID(id);
+            size_t telLen = r.writeTel(tel);
+            size_t birthLen = static_cast<size_t>(std::to_chars(birth, birth + sizeof(birth), r.birthYear()).ptr - birth);
+            cell(r.name(), W_NAME);
+            cell(std::string_view(id, sizeof(id)), W_ID);
+            cell(r.department(), W_DEPT);
+            cell(std::string_view(birth, birthLen), W_B_YEAR);
+            cell(std::string_view(tel, telLen), W_TEL, true);
+            break;
+        }
+        case TableFormat::CSV: {
+            r.writeID(id);
+            size_t telLen = r.writeTel(tel);
+            csvField(r.name());
+            buf += ',';
+            buf.append(id, sizeof(id));
+            buf += ',';
+            buf += std::to_string(r.birthYear());
+            buf += ',';
+            csvField(r.department());
+            buf += ',';
+            buf.append(tel, telLen);
+            buf += '\n';
+            break;
+        }
+    }
+    out_.maybeFlush();
+}
@@ -0,0 +1,71 @@
+#ifndef TABLE_WRITER_HPP
+#define TABLE_WRITER_HPP
+
+#include "StudentRecord.hpp"
+#include <cstdio>
+#include <string>
+
+// Buffered writer for a FILE*: text is collected in one reusable buffer and
+// written with one fwrite per block instead of one call per field
+class BlockWriter {
+public:
+    static constexpr size_t BLOCK = 1 << 20;
+
+    explicit BlockWriter(std::FILE* f) : f_(f) { buf_.reserve(BLOCK + 256); }
+    ~BlockWriter() { flush(); }
+    BlockWriter(const BlockWriter&) = delete;
+    BlockWriter& operator=(const BlockWriter&) = delete;
+
+    std::string& buffer() { return buf_; }
+    void maybeFlush() { if (buf_.size() >= BLOCK) flush(); }
+    void flush() {
+        if (!buf_.empty()) std::fwrite(buf_.data(), 1, buf_.size(), f_);
+        buf_.clear();
+    }
+
+private:
+    std::FILE*  f_;
+    std::string buf_;
+};
+
+// Table: the menu layout  "Name | Student ID | Dept | Birth Year | Tel"  (padded columns)
+// TSV:   the student file layout (name, id, birth year, department, tel)
+// CSV:   same columns as TSV with a header row; fields quoted when needed (RFC 4180)
+enum class TableFormat { Table, TSV, CSV };
+
+// Formats students straight into a BlockWriter buffer. Column padding is done with
+// appends from precomputed blank/separator strings, so a row costs a few memcpys.
+class TableWriter {
+public:
+    TableWriter(std::FILE* f, TableFormat format) : out_(f), format_(format) {}
+
+    // Column titles (Table: titles + separator line, CSV: header row, TSV: nothing)
+    void header();
+    void row(const StudentRecord& r);
+
+    template <typename Range>
+    void rows(const Range& list) { for (const auto& r : list) row(r); }
+
+    // Text outside the table (blank lines, notes)
+    void text(const std::string& s) { out_.buffer() += s; }
+    void flush()                    { out_.flush(); }
+
+    // "table" | "tsv" | "csv"
+    static bool parseFormat(const std::string& word, TableFormat& f);
+
+    // Column widths of the Table layout
+    static constexpr size_t W_NAME   = 15;
+    static constexpr size_t W_ID     = 10;
+    static constexpr size_t W_DEPT   = 20;
+    static constexpr size_t W_B_YEAR = 10;
+    static constexpr size_t W_TEL    = 12;
+
+private:
+    void cell(std::string_view s, size_t width, bool last = false);
+    void csvField(std::string_view s);
+
+    BlockWriter out_;
+    TableFormat format_;
+};
+
+#endif // TABLE_WRITER_HPP
@@ -0,0 +1,101 @@
+#include "TrigramIndex.hpp"
+#include <algorithm>
+#include <cctype>
+
+static inline unsigned char foldChar(char c) {
+    return static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+void TrigramIndex::clear() {
+    postings_.clear();
+}
+
+void TrigramIndex::gramsOf(std::string_view text, std::vector<uint32_t>& out) {
+    out.clear();
+    if (text.size() < 3) return;
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        out.push_back((uint32_t(foldChar(text[i])) << 16) |
+                      (uint32_t(foldChar(text[i + 1])) << 8) |
+                       uint32_t(foldChar(text[i + 2])));
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void TrigramIndex::add(size_t row, std::string_view text) {
+    std::vector<uint32_t> grams;
+    gramsOf(text, grams);
+    const uint32_t r = static_cast<uint32_t>(row);
+    for (uint32_t g : grams) {
+        auto& list = postings_[g];
+        // Rows are normally appended in increasing order; updates may re-add an older row
+        if (list.empty() || list.back() < r) list.push_back(r);
+        else {
+            auto it = std::lower_bound(list.begin(), list.end(), r);
+            if (it == list.end() || *it != r) list.insert(it, r);
+        }
+    }
+}
+
+void TrigramIndex::remove(size_t row, std::string_view text) {
+    std::vector<uint32_t> grams;
+    gramsOf(text, grams);
+    const uint32_t r = static_cast<uint32_t>(row);
+    for (uint32_t g : grams) {
+        auto pit = postings_.find(g);
+        if (pit == postings_.end()) continue;
+        auto& list = pit->second;
+        auto it = std::lower_bound(list.begin(), list.end(), r);
+        if (it != list.end() && *it == r) list.erase(it);
+        if (list.empty()) postings_.erase(pit);
+    }
+}
+
+bool TrigramIndex::candidates(const std::string& key, std::vector<size_t>& out) const {
+    out.clear();
+    if (key.size() < 3) return false;
+
+    std::vector<uint32_t> grams;
+    gramsOf(key, grams);
+
+    // Intersect starting from the shortest posting list
+    std::vector<const std::vector<uint32_t>*> lists;
+    lists.reserve(grams.size());
+    for (uint32_t g : grams) {
+        auto it = postings_.find(g);
+        if (it == postings_.end()) return true; // some trigram never occurs: no candidates
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b){
+        return a->size() < b->size();
+    });
+
+    std::vector<uint32_t> cur(*lists[0]), next;
+    for (size_t i = 1; i < lists.size() && !cur.empty(); ++i) {
+        next.clear();
+        std::set_intersection(cur.begin(), cur.end(), lists[i]->begin(), lists[i]->end(),
+                              std::back_inserter(next));
+        cur.swap(next);
+    }
+    out.assign(cur.begin(), cur.end());
+    return true;
+}
+
+size_t TrigramIndex::estimate(const std::string& key) const {
+    if (key.size() < 3) return SIZE_MAX;
+    std::vector<uint32_t> grams;
+    gramsOf(key, grams);
+    size_t best = SIZE_MAX;
+    for (uint32_t g : grams) {
+        auto it = postings_.find(g);
+        size_t n = (it == postings_.end()) ? 0 : it->second.size();
+        if (n < best) best = n;
+    }
+    return best;
+}
+
+bool TrigramIndex::containsFolded(std::string_view text, const std::string& lowerKey) {
+    auto it = std::search(text.begin(), text.end(), lowerKey.begin(), lowerKey.end(),
+                          [](char a, char b){ return foldChar(a) == static_cast<unsigned char>(b); });
+    return it != text.end() || lowerKey.empty();
+}
@@ -0,0 +1,38 @@
+#ifndef TRIGRAM_INDEX_HPP
+#define TRIGRAM_INDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Inverted index from case-folded 3-character substrings to row positions.
+// Used to narrow substring queries (name / department keyword) to a small
+// candidate set; candidates must still be verified by the caller.
+class TrigramIndex {
+public:
+    void clear();
+
+    // Register / unregister the text of one row
+    void add(size_t row, std::string_view text);
+    void remove(size_t row, std::string_view text);
+
+    // Collects the rows whose text contains every trigram of `key`, in ascending order.
+    // Returns false if `key` is shorter than 3 chars (the index cannot help; scan instead).
+    bool candidates(const std::string& key, std::vector<size_t>& out) const;
+
+    // Upper bound on candidates(key).size() (shortest posting list), without
+    // intersecting anything. Returns SIZE_MAX if the key is too short for the index.
+    size_t estimate(const std::string& key) const;
+
+    // Case-insensitive substring test; `lowerKey` must already be lower case
+    static bool containsFolded(std::string_view text, const std::string& lowerKey);
+
+private:
+    static void gramsOf(std::string_view text, std::vector<uint32_t>& out); // sorted, unique
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings_; // trigram -> sorted rows
+};
+
+#endif // TRIGRAM_INDEX_HPP
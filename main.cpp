@@ -1,6 +1,9 @@
 #include "StudentDB.hpp"
+#include "CommandLine.hpp"
+#include "TableWriter.hpp"
+#include <algorithm>
+#include <fstream>
 #include <iostream>
-#include <iomanip>
 #include <limits>
 #include <sstream>
 #include <set>
@@ -40,53 +43,87 @@ static void printUpdateMenu() {
                 "3. Update Telephone Number\n> ";
 }
 
-static void printStudents(const std::vector<Student>& list) {
-    const int W_NAME   = 15;
-    const int W_ID     = 10;
-    const int W_DEPT   = 20;
-    const int W_B_YEAR = 10;
-    const int W_TEL    = 12;
-
-    std::cout << '\n'
-              << std::left
-              << std::setw(W_NAME)   << "Name" << " | "
-              << std::setw(W_ID)     << "Student ID" << " | "
-              << std::setw(W_DEPT)   << "Dept" << " | "
-              << std::setw(W_B_YEAR) << "Birth Year" << " | "
-              << std::setw(W_TEL)    << "Tel"
-              <<'\n';
+static void printStatsMenu() {
+    std::cout << "\n- Statistics Option -\n"
+                 "1. Group Summary\n"
+                 "2. Operation Metrics\n"
+                 "3. Dump Metrics (JSON)\n> ";
+}
 
-    for (int i = 0; i < W_NAME + 1; i++) std::cout << '-';
-    std::cout << "+-";
-    for (int i = 0; i < W_ID + 1; i++) std::cout << '-';
-    std::cout << "+-";
-    for (int i = 0; i < W_DEPT + 1; i++) std::cout << '-';
-    std::cout << "+-";
-    for (int i = 0; i < W_B_YEAR + 1; i++) std::cout << '-';
-    std::cout << "+-";
-    for (int i = 0; i < W_TEL + 1; i++) std::cout << '-';
-    std::cout << '\n';
+// Rows per page in listings
+static const size_t PAGE_ROWS = 20;
 
-    for (const auto& s : list) {
-        std::cout << std::left
-                  << std::setw(W_NAME)   << s.name << " | "
-                  << std::setw(W_ID)     << s.studentID << " | "
-                  << std::setw(W_DEPT)   << s.department << " | "
-                  << std::setw(W_B_YEAR) << s.birthYear << " | "
-                  << std::setw(W_TEL)    << s.tel
-                  <<'\n';
+// Prints `total` rows one page at a time: printPage(out, offset, count) writes rows
+// [offset, offset + count). After each page but the last, Enter shows the next
+// page and q stops, so only the pages actually viewed are fetched.
+template <typename PrintPage>
+static void pageStudents(size_t total, PrintPage printPage) {
+    TableWriter out(stdout, TableFormat::Table);
+    out.text("\n");
+    out.header();
+    for (size_t offset = 0; offset < total; offset += PAGE_ROWS) {
+        size_t count = std::min(PAGE_ROWS, total - offset);
+        printPage(out, offset, count);
+        if (offset + count >= total) break;
+        out.flush();
+        std::cout << "-- " << offset + 1 << '-' << offset + count << " of " << total
+                  << " (Enter: next page, q: stop) --";
+        std::string line;
+        if (!getline(std::cin, line) || line == "q" || line == "Q") break;
     }
-    std::cout << '\n';
+    out.text("\n");
+}
+
+// Search results, in the order the search returned them
+static void printStudents(const ResultView& list) {
+    pageStudents(list.size(), [&list](TableWriter& out, size_t offset, size_t count) {
+        for (size_t i = offset; i < offset + count; ++i) out.row(list[i]);
+    });
+}
+
+// Whole table in the current sort key order: one walk of the sorted index, continued
+// page by page (pages are shown in order and the table does not change meanwhile)
+static void printAll(const StudentDB& db) {
+    SortedView view = db.sortByKey();
+    auto it = view.begin();
+    pageStudents(view.size(), [&it](TableWriter& out, size_t, size_t count) {
+        for (size_t i = 0; i < count; ++i, ++it) out.row(*it);
+    });
 }
+
 // Main Function
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: a.exe file1.txt\n\n";
+        CommandLine::printUsage(std::cerr);
         return 1;
     }
+    // Client commands talk to a running server and need no student file
+    if (CommandLine::isClientCommand(argv[1])) {
+        return CommandLine::runClient(std::vector<std::string>(argv + 1, argv + argc));
+    }
     StudentDB db(argv[1]);
+
+    std::vector<std::string> command;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        // --journal: each save appends to file1.txt.wal instead of rewriting the whole file
+        if (command.empty() && arg == "--journal") db.setPersistence(Persistence::Journal);
+        // --partitioned: one file per admission year in file1.txt.parts/, loaded on demand
+        else if (command.empty() && arg == "--partitioned") db.setPersistence(Persistence::Partitioned);
+        // --metrics: record operation counts and latencies (Statistics > Operation Metrics)
+        else if (command.empty() && arg == "--metrics") Metrics::setEnabled(true);
+        else if (!command.empty() || CommandLine::isCommand(arg)) command.push_back(arg);
+        else { CommandLine::printUsage(std::cerr); return 1; }
+    }
     db.load();
 
+    // Non-interactive mode: run one subcommand and exit
+    if (!command.empty()) {
+        int code = CommandLine::run(db, command);
+        if (Metrics::enabled()) Metrics::global().dumpJSON(std::cerr); // machine-readable, off stdout
+        return code;
+    }
+
     while (true) {
         printMainMenu();
         int sel{};
@@ -223,8 +260,7 @@ int main(int argc, char* argv[]) {
                 auto res = db.searchByDepartmentKeyword(kw);
                 printStudents(res);
             } else if (opt == 6) {
-                auto res = db.sortByKey();
-                printStudents(res);
+                printAll(db);
             } else {
                 std::cout << "\nInvalid input. Please insert a number between 1 to 6.\n\n";
                 continue;
@@ -254,8 +290,7 @@ int main(int argc, char* argv[]) {
                 std::cout << "\nInvalid input. Please insert a number between 1 to 4.\n\n";
                 continue;
             }
-            db.sortByKey();
-            db.save();
+            // Listings read the sorted index of the selected key; nothing to rewrite on disk
             std::cout << "\nSorting updated.\n\n";
         }
         // 5. Update
@@ -312,42 +347,77 @@ int main(int argc, char* argv[]) {
         }
         // 6. Statistics
         else if (sel == 6) { 
-            if (db.isEmpty()) {
-                std::cout << "\nDatabase is empty. Please insert students first.\n\n";
-            } else {
-                std::cout << "\n[Statistics]\n"
-                             "Choose grouping order (1~3 items, space-separated):\n"
-                             "  1) Admission Year\n"
-                             "  2) Birth Year\n"
-                             "  3) Department\n"
-                             "Examples:\n"
-                             "  1            -> Admission Year\n"
-                             "  1 2          -> Admission Year -> Birth Year\n"
-                             "  3 1 2        -> Department -> Admission Year -> Birth Year\n"
-                             "> ";
+            printStatsMenu();
+            int u{};
+            if (!(std::cin >> u)) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::cout << "\nInvalid input. Please insert a number between 1 to 3.\n\n";
+                continue;
+            }
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
-                std::string line;
-                std::getline(std::cin, line);
+            if (u == 1) {
+                if (db.isEmpty()) {
+                    std::cout << "\nDatabase is empty. Please insert students first.\n\n";
+                } else {
+                    std::cout << "\n[Statistics]\n"
+                                 "Choose grouping order (1~3 items, space-separated):\n"
+                                 "  1) Admission Year\n"
+                                 "  2) Birth Year\n"
+                                 "  3) Department\n"
+                                 "Examples:\n"
+                                 "  1            -> Admission Year\n"
+                                 "  1 2          -> Admission Year -> Birth Year\n"
+                                 "  3 1 2        -> Department -> Admission Year -> Birth Year\n"
+                                 "> ";
 
-                std::istringstream iss(line);
-                int x;
-                std::vector<StatKey> order;
-                while (iss >> x) {
-                    if      (x == 1) order.push_back(StatKey::AdmissionYear);
-                    else if (x == 2) order.push_back(StatKey::BirthYear);
-                    else if (x == 3) order.push_back(StatKey::Department);
-                }
+                    std::string line;
+                    std::getline(std::cin, line);
+
+                    std::istringstream iss(line);
+                    int x;
+                    std::vector<StatKey> order;
+                    while (iss >> x) {
+                        if      (x == 1) order.push_back(StatKey::AdmissionYear);
+                        else if (x == 2) order.push_back(StatKey::BirthYear);
+                        else if (x == 3) order.push_back(StatKey::Department);
+                    }
 
-                if (order.empty() || order.size() > 3 || std::set<StatKey>(order.begin(), order.end()).size() != order.size()) {
-                    std::cout << "\nInvalid input. Please follow this format : 2 1 3\n\n";
+                    if (order.empty() || order.size() > 3 || std::set<StatKey>(order.begin(), order.end()).size() != order.size()) {
+                        std::cout << "\nInvalid input. Please follow this format : 2 1 3\n\n";
+                    } else {
+                        db.groupSummary(order, std::cout);
+                    }
+                }
+            } else if (u == 2) {
+                std::cout << '\n';
+                if (!Metrics::enabled()) std::cout << "(Metrics are off; start with --metrics to record them.)\n";
+                Metrics::global().print(std::cout);
+                std::cout << '\n';
+            } else if (u == 3) {
+                std::string path;
+                std::cout << "\nOutput file ? (- for screen)\n"; getline(std::cin, path);
+                if (path == "-") {
+                    Metrics::global().dumpJSON(std::cout);
+                    std::cout << '\n';
                 } else {
-                    db.groupSummary(order, std::cout);
+                    std::ofstream dump(path);
+                    if (dump.is_open()) {
+                        Metrics::global().dumpJSON(dump);
+                        std::cout << "Written.\n\n";
+                    } else {
+                        std::cout << "Error : cannot write file " << path << "\n\n";
+                    }
                 }
+            } else {
+                std::cout << "\nInvalid input. Please insert a number between 1 to 3.\n\n";
+                continue;
             }
         }
         // 7. Exit
         else if (sel == 7) {
-            db.save();
+            db.checkpoint(); // leave a complete file behind (no journal)
             break;
         }
         else {